@@ -0,0 +1,600 @@
+/*
+ * Strange Weather - headless benchmark
+ *
+ * Times the engine and display code against the Rack stub in this directory, so
+ * changes can be compared without running Rack. Build and run with `make bench`.
+ *
+ *   bench [--csv] [--seconds S] [--suite engine|audio|thomas|shared|reset|trail|render|check]
+ *
+ * Every case is timed several times and the fastest run is reported. The check suite
+ * verifies behaviour instead, and the benchmark exits non-zero if any check fails.
+ */
+
+// Built as one translation unit with the module so the benchmark can reach its internals
+#include "../src/StrangeWeather.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+
+namespace {
+
+const float SAMPLE_RATE = 48000.f;
+const int REPEATS = 3;
+bool csvOutput = false;
+double benchSeconds = 1.0;  // Audio time per engine measurement
+
+const char* typeNames[4] = {"SprottB", "Rossler", "Thomas", "Dadras"};
+const char* rangeNames[3] = {"Low", "Med", "High"};
+const char* styleNames[3] = {"Trace", "Lissajous", "Scope"};
+enum Integrator { RK4, RK4_FLOAT, DOPRI, TABLE, NUM_INTEGRATORS };
+const char* integratorNames[NUM_INTEGRATORS] = {"rk4", "rk4f", "dopri", "table"};
+
+double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Time `iterations` calls of fn, keeping the fastest of REPEATS runs; returns ns per call
+template <class F>
+double timeIt(long iterations, F fn) {
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; r++) {
+        double t0 = now();
+        for (long i = 0; i < iterations; i++) {
+            fn();
+        }
+        best = std::min(best, now() - t0);
+    }
+    return best * 1e9 / iterations;
+}
+
+void printHeader(const char* suite, const char* columns) {
+    if (csvOutput)
+        return;
+    std::printf("\n== %s ==\n%s\n", suite, columns);
+}
+
+void printRow(const char* suite, const std::string& name, double value, const char* unit, const std::string& extra = "") {
+    if (csvOutput)
+        std::printf("%s,%s,%.3f,%s%s%s\n", suite, name.c_str(), value, unit, extra.empty() ? "" : ",", extra.c_str());
+    else
+        std::printf("%-36s %12.3f %-10s %s\n", name.c_str(), value, unit, extra.c_str());
+}
+
+std::string caseName(const char* a, const char* b, const char* c = nullptr, const char* d = nullptr) {
+    std::string s = a;
+    for (const char* part : {b, c, d}) {
+        if (part) {
+            s += "/";
+            s += part;
+        }
+    }
+    return s;
+}
+
+// Module with every bank running `type` at `range`, settled past any re-seed crossfade
+StrangeWeather* makeModule(AttractorType type, int range, int controlRate, Integrator integrator) {
+    StrangeWeather* m = new StrangeWeather;
+    for (int i = 0; i < 4; i++) {
+        m->params[StrangeWeather::SHAPE_A_PARAM + i].setValue(3.f - type);
+        m->params[StrangeWeather::RANGE_A_PARAM + i].setValue(range);
+    }
+    m->controlRate = controlRate;
+    m->adaptiveIntegrator = integrator == DOPRI;
+    m->floatEngine = integrator == RK4_FLOAT;
+    if (integrator == TABLE) {
+        AttractorOrbitTable::build();
+    }
+    m->setOrbitTables(integrator == TABLE);
+
+    StrangeWeather::ProcessArgs args{SAMPLE_RATE, 1.f / SAMPLE_RATE, 0};
+    // Request the new shape's seeds, give the seeder thread time to deliver them, then
+    // run past the crossfade (and the one onto the orbit table, which follows it)
+    for (int n = 0; n < (int)(0.1f * SAMPLE_RATE); n++) {
+        m->process(args);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (int n = 0; n < (int)((2.f * StrangeWeather::RESEED_FADE_TIME + StrangeWeather::ORBIT_HOLD_TIME + 0.1f) * SAMPLE_RATE); n++) {
+        m->process(args);
+    }
+    return m;
+}
+
+// process() cost for every shape, range, control rate and integrator
+void benchEngine() {
+    printHeader("engine", "shape/range/rate/integrator            ns/sample");
+    StrangeWeather::ProcessArgs args{SAMPLE_RATE, 1.f / SAMPLE_RATE, 0};
+    long samples = (long)(benchSeconds * SAMPLE_RATE);
+    for (int integrator = 0; integrator < NUM_INTEGRATORS; integrator++) {
+        for (int t = 0; t < 4; t++) {
+            for (int range = 0; range < 3; range++) {
+                for (int rate = 0; rate < StrangeWeather::NUM_CONTROL_RATES; rate++) {
+                    StrangeWeather* m = makeModule((AttractorType)t, range, rate, (Integrator)integrator);
+                    double ns = timeIt(samples, [&]() { m->process(args); });
+                    std::string block = "block" + std::to_string(StrangeWeather::controlBlockSize(rate));
+                    printRow("engine", caseName(typeNames[t], rangeNames[range], block.c_str(), integratorNames[integrator]),
+                             ns, "ns/sample");
+                    delete m;
+                }
+            }
+        }
+    }
+}
+
+// process() cost with every bank at audio rate (200 Hz), for 1 and 16 voices per bank
+void benchAudio() {
+    printHeader("audio", "shape/voices/precision                  ns/sample");
+    StrangeWeather::ProcessArgs args{SAMPLE_RATE, 1.f / SAMPLE_RATE, 0};
+    long samples = (long)(benchSeconds * SAMPLE_RATE);
+    for (int integrator = RK4; integrator <= RK4_FLOAT; integrator++) {
+        for (int t = 0; t < 4; t++) {
+            for (int voices : {1, 16}) {
+                StrangeWeather* m = makeModule((AttractorType)t, 2, 0, (Integrator)integrator);
+                for (int i = 0; i < 4; i++) {
+                    m->audioRate[i] = true;
+                    m->channels[i] = voices;
+                }
+                // New voices are re-seeded and crossfaded in
+                for (int n = 0; n < (int)(2.f * StrangeWeather::RESEED_FADE_TIME * SAMPLE_RATE); n++) {
+                    m->process(args);
+                }
+                double ns = timeIt(samples, [&]() { m->process(args); });
+                std::string count = std::to_string(voices) + "voice";
+                printRow("audio", caseName(typeNames[t], count.c_str(), integratorNames[integrator]), ns, "ns/sample");
+                delete m;
+            }
+        }
+    }
+}
+
+// Thomas with the exact and the fast sine, at High range for each integrator and at
+// audio rate with 16 voices per bank
+void benchThomas() {
+    printHeader("thomas", "case/sine                               ns/sample");
+    StrangeWeather::ProcessArgs args{SAMPLE_RATE, 1.f / SAMPLE_RATE, 0};
+    long samples = (long)(benchSeconds * SAMPLE_RATE);
+    const char* sineNames[2] = {"exact", "fast"};
+    for (int integrator = RK4; integrator <= DOPRI; integrator++) {
+        for (int fast = 0; fast < 2; fast++) {
+            StrangeWeather* m = makeModule(THOMAS, 2, 0, (Integrator)integrator);
+            m->fastSine = fast;
+            double ns = timeIt(samples, [&]() { m->process(args); });
+            printRow("thomas", caseName("High", integratorNames[integrator], sineNames[fast]), ns, "ns/sample");
+            delete m;
+        }
+    }
+    for (int integrator = RK4; integrator <= RK4_FLOAT; integrator++) {
+        for (int fast = 0; fast < 2; fast++) {
+            StrangeWeather* m = makeModule(THOMAS, 2, 0, (Integrator)integrator);
+            m->fastSine = fast;
+            for (int i = 0; i < 4; i++) {
+                m->audioRate[i] = true;
+                m->channels[i] = 16;
+            }
+            for (int n = 0; n < (int)(2.f * StrangeWeather::RESEED_FADE_TIME * SAMPLE_RATE); n++) {
+                m->process(args);
+            }
+            double ns = timeIt(samples, [&]() { m->process(args); });
+            printRow("thomas", caseName("audio16", integratorNames[integrator], sineNames[fast]), ns, "ns/sample");
+            delete m;
+        }
+    }
+}
+
+// Many instances in their default patch (a different shape per bank, High range, every
+// 16 samples), each integrating on its own and through the shared engine. All run on
+// this thread, in the engine's order; the cost is per instance.
+void benchShared() {
+    printHeader("shared", "instances/engine                        ns/sample");
+    StrangeWeather::ProcessArgs args{SAMPLE_RATE, 1.f / SAMPLE_RATE, 0};
+    long samples = (long)(benchSeconds * SAMPLE_RATE);
+    const char* engineNames[2] = {"own", "shared"};
+    for (int count : {1, 8, 32}) {
+        for (int shared = 0; shared < 2; shared++) {
+            std::vector<StrangeWeather*> modules;
+            for (int k = 0; k < count; k++) {
+                StrangeWeather* m = new StrangeWeather;
+                m->controlRate = 1;
+                m->sharedEngine = shared;
+                modules.push_back(m);
+            }
+            auto step = [&]() {
+                for (StrangeWeather* m : modules) {
+                    m->process(args);
+                }
+            };
+            // Past the initial re-seeds and their crossfades
+            for (int n = 0; n < (int)(0.1f * SAMPLE_RATE); n++) {
+                step();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            for (int n = 0; n < (int)((2.f * StrangeWeather::RESEED_FADE_TIME + 0.1f) * SAMPLE_RATE); n++) {
+                step();
+            }
+            double ns = timeIt(samples, step) / count;
+            std::string instances = std::to_string(count);
+            printRow("shared", caseName(instances.c_str(), engineNames[shared]), ns, "ns/sample");
+            for (StrangeWeather* m : modules) {
+                delete m;
+            }
+        }
+    }
+}
+
+int checkFailures = 0;
+
+void check(const std::string& name, bool ok) {
+    printRow("check", name, ok ? 1.0 : 0.0, ok ? "pass" : "FAIL");
+    if (!ok) {
+        checkFailures++;
+    }
+}
+
+// Minimal expander bus consumer, as a companion module would implement it
+struct BusConsumer : Module, StrangeWeatherBus::Consumer {
+    StrangeWeatherBus::Message messages[2];
+    uint32_t banks = (1 << StrangeWeatherBus::BANKS) - 1;
+    BusConsumer() {
+        leftExpander.producerMessage = &messages[0];
+        leftExpander.consumerMessage = &messages[1];
+        messages[0].version = messages[1].version = 0;
+    }
+    uint32_t busBanks() override {
+        return banks;
+    }
+    // The last message the producer on the left flipped to us, while it is still there
+    const StrangeWeatherBus::Message* message() {
+        const StrangeWeatherBus::Message* msg = (const StrangeWeatherBus::Message*)leftExpander.consumerMessage;
+        if (msg->version != StrangeWeatherBus::VERSION || !leftExpander.module || leftExpander.module->id != msg->moduleId)
+            return nullptr;
+        return msg;
+    }
+};
+
+// What Rack's engine does with expander messages after every module has processed
+void flipMessages(Module* m) {
+    for (Module::Expander* side : {&m->leftExpander, &m->rightExpander}) {
+        if (side->messageFlipRequested) {
+            std::swap(side->producerMessage, side->consumerMessage);
+            side->messageFlipRequested = false;
+        }
+    }
+}
+
+// Expander bus: flipped messages match the outputs, both sides get the same state, the
+// moduleId guard rejects other modules, and banks only consumers read stay awake
+void checkBus() {
+    StrangeWeather::ProcessArgs args{SAMPLE_RATE, 1.f / SAMPLE_RATE, 0};
+    StrangeWeather* m = makeModule(SPROTT_B, 2, 1, RK4);
+    m->id = 42;
+    BusConsumer* right = new BusConsumer;
+    BusConsumer* left = new BusConsumer;
+    // A consumer on the left reads through its right side
+    std::swap(left->leftExpander, left->rightExpander);
+    auto attach = [&]() {
+        m->rightExpander.module = right;
+        right->leftExpander.module = m;
+        m->leftExpander.module = left;
+        left->rightExpander.module = m;
+        m->onExpanderChange(Module::ExpanderChangeEvent{0});
+    };
+    auto step = [&]() {
+        m->process(args);
+        flipMessages(right);
+        flipMessages(left);
+    };
+    attach();
+    check("bus/nothing before the first flip", right->message() == nullptr);
+    for (int n = 0; n < 100; n++) {
+        step();
+    }
+
+    const StrangeWeatherBus::Message* msg = right->message();
+    bool matches = msg != nullptr;
+    for (int i = 0; matches && i < 4; i++) {
+        const StrangeWeatherBus::Bank& bank = msg->banks[i];
+        matches = bank.channels == 1 && !bank.suspended &&
+                  std::fabs(bank.smoothed[0][0] * 5.f - m->outputs[StrangeWeather::A_X_OUTPUT + i * 4].getVoltage()) < 1e-5f &&
+                  std::fabs(bank.smoothed[2][0] * 5.f - m->outputs[StrangeWeather::A_Z_OUTPUT + i * 4].getVoltage()) < 1e-5f &&
+                  bank.min[0][0] < bank.max[0][0];
+    }
+    check("bus/state matches outputs", matches &&
+          msg->combined[0] == m->outputs[StrangeWeather::COMB_SUM_OUTPUT].getVoltage() && msg->trails == &m->trails);
+    const StrangeWeatherBus::Message* other = (const StrangeWeatherBus::Message*)left->rightExpander.consumerMessage;
+    check("bus/same message both sides", msg && other->moduleId == 42 &&
+          std::memcmp(&other->banks, &msg->banks, sizeof(msg->banks)) == 0);
+
+    TrailSnapshot* snapshot = new TrailSnapshot;
+    snapshot->update(*msg->trails);
+    check("bus/trails via snapshot", snapshot->valid == m->trails.valid);
+    delete snapshot;
+
+    // Another module taking the producer's place
+    StrangeWeather* stranger = new StrangeWeather;
+    stranger->id = 43;
+    right->leftExpander.module = stranger;
+    check("bus/moduleId guard", right->message() == nullptr);
+    delete stranger;
+
+    // With nothing patched and the display on a view that shows no bank (Ajman),
+    // only the banks consumers read are in use
+    m->displayMode = 6;
+    right->banks = left->banks = 0;
+    attach();
+    right->banks = 1;
+    for (int n = 0; n < 100; n++) {
+        step();
+    }
+    msg = right->message();
+    check("bus/unread banks suspended", msg && !msg->banks[0].suspended && msg->banks[1].suspended &&
+          msg->banks[2].suspended && msg->banks[3].suspended);
+    left->banks = 1 << 2;
+    for (int n = 0; n < 100; n++) {
+        step();
+    }
+    msg = right->message();
+    check("bus/read banks stay awake", msg && !msg->banks[0].suspended && msg->banks[1].suspended &&
+          !msg->banks[2].suspended);
+
+    m->rightExpander.module = m->leftExpander.module = nullptr;
+    delete right;
+    delete left;
+    delete m;
+}
+
+bool sameState(const Attractor& a, const Attractor& b) {
+    const double sa[9] = {a.x, a.y, a.z, a.minX, a.maxX, a.minY, a.maxY, a.minZ, a.maxZ};
+    const double sb[9] = {b.x, b.y, b.z, b.minX, b.maxX, b.minY, b.maxY, b.minZ, b.maxZ};
+    return std::memcmp(sa, sb, sizeof(sa)) == 0;
+}
+
+// AttractorLanes::advance, which catches up suspended banks on the seeder thread, lands
+// on exactly the state a scalar step(MAX_STEP) loop reaches, for every shape in one
+// mixed batch
+void checkAdvance() {
+    const double span = 1000.0;
+    Attractor lanes[4], scalar[4];
+    Attractor* group[4];
+    double spans[4];
+    for (int t = 0; t < 4; t++) {
+        lanes[t].type = (AttractorType)t;
+        lanes[t].chaos = 0.3f + 0.1f * t;
+        lanes[t].resetState();
+        scalar[t] = lanes[t];
+        group[t] = &lanes[t];
+        spans[t] = span;
+    }
+    AttractorLanes engine;
+    engine.advance(group, 4, spans);
+    long steps = (long)std::ceil(span / AttractorLanes::MAX_STEP);
+    for (int t = 0; t < 4; t++) {
+        scalar[t].warmup(steps, AttractorLanes::MAX_STEP);
+        check(caseName("advance", typeNames[t], "matches step loop"), sameState(lanes[t], scalar[t]));
+    }
+
+    // The same through the seeder thread, as resumeBank requests it
+    std::shared_ptr<AttractorSeeder::Slots> slots = std::make_shared<AttractorSeeder::Slots>(4);
+    AttractorSeeder::add(slots);
+    for (int t = 0; t < 4; t++) {
+        scalar[t] = lanes[t];
+        AttractorSeeder::requestAdvance(slots->slots[t], lanes[t], span);
+        scalar[t].warmup(steps, AttractorLanes::MAX_STEP);
+    }
+    for (int t = 0; t < 4; t++) {
+        AttractorSeeder::Slot& slot = slots->slots[t];
+        for (int wait = 0; wait < 1000 && slot.state.load(std::memory_order_acquire) != AttractorSeeder::READY; wait++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        check(caseName("advance", typeNames[t], "through the seeder"),
+              slot.state.load(std::memory_order_acquire) == AttractorSeeder::READY && sameState(slot.staged, scalar[t]));
+    }
+    AttractorSeeder::remove(slots);
+}
+
+// A patch saved mid-run and loaded into a new module carries on bit-identically, with
+// polyphonic banks and with the adaptive integrator's step size. Rack writes reals with
+// 17 significant digits, so the text round trip the stub skips is exact too. The save
+// comes after the added voices have faded in: one saved during a re-seed crossfade
+// loads straight onto the new seed.
+void checkReload() {
+    StrangeWeather::ProcessArgs args{SAMPLE_RATE, 1.f / SAMPLE_RATE, 0};
+    for (int integrator : {RK4, DOPRI}) {
+        for (int t = 0; t < 4; t++) {
+            StrangeWeather* m = makeModule((AttractorType)t, 2, 1, (Integrator)integrator);
+            m->channels[1] = 3;
+            m->outputs[StrangeWeather::COMB_SUM_OUTPUT].connected = true;
+            for (int n = 0; n < (int)((2.f * StrangeWeather::RESEED_FADE_TIME + 0.5f) * SAMPLE_RATE); n++) {
+                m->process(args);
+            }
+
+            // Rack sets the params, then hands over the module's own data
+            StrangeWeather* loaded = new StrangeWeather;
+            for (int p = 0; p < StrangeWeather::NUM_PARAMS; p++) {
+                loaded->params[p].setValue(m->params[p].getValue());
+            }
+            loaded->outputs[StrangeWeather::COMB_SUM_OUTPUT].connected = true;
+            loaded->dataFromJson(m->dataToJson());
+
+            bool same = true;
+            for (int n = 0; n < (int)SAMPLE_RATE; n++) {
+                m->process(args);
+                loaded->process(args);
+                for (int o = 0; o < StrangeWeather::NUM_OUTPUTS; o++) {
+                    same = same && m->outputs[o].getChannels() == loaded->outputs[o].getChannels() &&
+                           std::memcmp(m->outputs[o].voltages, loaded->outputs[o].voltages, sizeof(m->outputs[o].voltages)) == 0;
+                }
+            }
+            check(caseName("reload", typeNames[t], integratorNames[integrator]), same);
+            delete loaded;
+            delete m;
+        }
+    }
+}
+
+void benchCheck() {
+    printHeader("check", "check                                   result");
+    checkBus();
+    checkAdvance();
+    checkReload();
+}
+
+// Re-seeding one attractor: the seed cache path used by resetState() and the full warmup
+void benchReset() {
+    printHeader("reset", "shape/path                              us/reset");
+    double t0 = now();
+    AttractorSeedCache::build();
+    printRow("reset", "SeedCache/build", (now() - t0) * 1e6, "us", "once per process");
+
+    for (int t = 0; t < 4; t++) {
+        Attractor a;
+        a.type = (AttractorType)t;
+        a.chaos = 0.5f;
+        double cached = timeIt(2000, [&]() { a.resetState(); });
+        printRow("reset", caseName(typeNames[t], "cache"), cached / 1000.0, "us/reset");
+        double scratch = timeIt(20, [&]() { a.warmupFromScratch(); });
+        printRow("reset", caseName(typeNames[t], "warmup"), scratch / 1000.0, "us/reset");
+    }
+}
+
+// Engine-side trail write and UI-side snapshot refresh
+void benchTrail() {
+    printHeader("trail", "operation                               ns/call");
+    StrangeWeather* m = makeModule(SPROTT_B, 2, 0, RK4);
+    double write = timeIt(1 << 20, [&]() { m->writeTrailSample(); });
+    printRow("trail", "writeTrailSample", write, "ns/call");
+
+    // A frame that sees one new sample, and one that sees a whole trail's worth
+    TrailSnapshot* snapshot = new TrailSnapshot;
+    snapshot->update(m->trails);
+    double incremental = timeIt(1 << 16, [&]() {
+        m->writeTrailSample();
+        snapshot->update(m->trails);
+    }) - write;
+    printRow("trail", "TrailSnapshot::update/1 sample", incremental, "ns/call");
+    double full = timeIt(256, [&]() {
+        for (int n = 0; n < TrailBuffer::LENGTH; n++) {
+            m->writeTrailSample();
+        }
+        snapshot->update(m->trails);
+    }) - write * TrailBuffer::LENGTH;
+    printRow("trail", "TrailSnapshot::update/full", full, "ns/call");
+    delete snapshot;
+    delete m;
+}
+
+// One display frame per new trail sample, for every style in 2D and 3D, at the default
+// and the longest trail. NanoVG only counts calls here, so this measures the CPU side
+// of drawing (projection, sorting, batching) and the size of what is submitted.
+void benchRender() {
+    printHeader("render", "style/view/mode/trail                   us/frame   (per frame: paths vertices fills strokes)");
+    StrangeWeather* m = makeModule(SPROTT_B, 2, 0, RK4);
+    const float trailKnobs[2] = {0.7f, 1.f};
+    const int modes[2] = {5, 0};
+    const char* modeNames[2] = {"All", "A"};
+    NVGcontext* vg = APP->window->vg;
+    NVGcontext* fbVg = APP->window->fbVg;
+
+    for (int style = 0; style < 3; style++) {
+        for (int is3D = 0; is3D < 2; is3D++) {
+            for (int mi = 0; mi < 2; mi++) {
+                for (float knob : trailKnobs) {
+                    m->displayStyle = style;
+                    m->display3D = is3D;
+                    m->displayMode = modes[mi];
+                    m->params[StrangeWeather::TRAIL_PARAM].setValue(knob);
+
+                    AttractorDisplay* display = new AttractorDisplay;
+                    display->box.size = mm2px(Vec(60.0, 60.0));
+                    display->module = m;
+
+                    // Fill the whole history with real trajectories before timing
+                    auto stepTrail = [&]() {
+                        for (int i = 0; i < 4; i++) {
+                            Attractor& a = m->attractors[i][0];
+                            a.step(0.01);
+                            m->displayX[i] = clamp(a.getNormX() / 5.f, -1.f, 1.f);
+                            m->displayY[i] = clamp(a.getNormY() / 5.f, -1.f, 1.f);
+                            m->displayZ[i] = clamp(a.getNormZ() / 5.f, -1.f, 1.f);
+                        }
+                        m->writeTrailSample();
+                    };
+                    for (int n = 0; n < TrailBuffer::LENGTH; n++) {
+                        stepTrail();
+                    }
+
+                    Widget::DrawArgs args;
+                    args.vg = vg;
+                    args.clipBox = display->box.zeroPos();
+                    const int frames = 200;
+                    *vg = NVGcontext();
+                    *fbVg = NVGcontext();
+                    double ns = timeIt(frames, [&]() {
+                        stepTrail();
+                        display->step();
+                        display->draw(args);
+                    });
+                    long total = (long)frames * REPEATS;
+                    long paths = vg->paths + fbVg->paths;
+                    long vertices = vg->vertices + fbVg->vertices;
+                    long fills = vg->fills + fbVg->fills;
+                    long strokes = vg->strokes + fbVg->strokes;
+                    char extra[96];
+                    std::snprintf(extra, sizeof(extra), csvOutput ? "%ld,%ld,%ld,%ld" : "%ld %ld %ld %ld",
+                                  paths / total, vertices / total, fills / total, strokes / total);
+                    std::string trailLen = std::to_string(m->getTrailLength());
+                    printRow("render", caseName(styleNames[style], is3D ? "3D" : "2D", modeNames[mi], trailLen.c_str()),
+                             ns / 1000.0, "us/frame", extra);
+                    delete display;
+                }
+            }
+        }
+    }
+    delete m;
+}
+
+}  // namespace
+
+
+int main(int argc, char** argv) {
+    const char* suite = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--csv")) {
+            csvOutput = true;
+        }
+        else if (!std::strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            benchSeconds = std::max(std::atof(argv[++i]), 0.01);
+        }
+        else if (!std::strcmp(argv[i], "--suite") && i + 1 < argc) {
+            suite = argv[++i];
+        }
+        else {
+            std::fprintf(stderr, "usage: %s [--csv] [--seconds S] [--suite engine|audio|thomas|shared|reset|trail|render|check]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (csvOutput) {
+        std::printf("suite,case,value,unit,paths,vertices,fills,strokes\n");
+    }
+
+    // The reset suite times the cache build itself, so run it first
+    if (!suite || !std::strcmp(suite, "reset"))
+        benchReset();
+    if (!suite || !std::strcmp(suite, "trail"))
+        benchTrail();
+    if (!suite || !std::strcmp(suite, "render"))
+        benchRender();
+    if (!suite || !std::strcmp(suite, "engine"))
+        benchEngine();
+    if (!suite || !std::strcmp(suite, "audio"))
+        benchAudio();
+    if (!suite || !std::strcmp(suite, "thomas"))
+        benchThomas();
+    if (!suite || !std::strcmp(suite, "shared"))
+        benchShared();
+    if (!suite || !std::strcmp(suite, "check"))
+        benchCheck();
+    return checkFailures ? 1 : 0;
+}
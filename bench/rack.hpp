@@ -0,0 +1,542 @@
+// Minimal stand-in for the subset of the VCV Rack 2 SDK used by this plugin, so the
+// engine and display code can be built and timed outside Rack (see bench.cpp). Only
+// what the benchmark exercises behaves like Rack: ports, params, SIMD and the display
+// maths. NanoVG calls draw nothing; they only count the work submitted, and JSON
+// is an in-memory tree that is never written out.
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <immintrin.h>
+#include <cstdio>
+#include <sys/stat.h>
+
+// JSON is kept as an in-memory tree, enough for the reload check to round-trip a patch.
+// Nothing is ever freed.
+struct json_t {
+    enum Kind { OBJECT, ARRAY, INTEGER, REAL, BOOLEAN, STRING } kind;
+    long long integer = 0;
+    double real = 0.0;
+    std::string string;
+    std::vector<std::pair<std::string, json_t*>> object;
+    std::vector<json_t*> array;
+    explicit json_t(Kind kind) : kind(kind) {}
+};
+inline json_t* json_object() { return new json_t(json_t::OBJECT); }
+inline json_t* json_array() { return new json_t(json_t::ARRAY); }
+inline bool json_is_array(const json_t* j) { return j && j->kind == json_t::ARRAY; }
+inline bool json_is_object(const json_t* j) { return j && j->kind == json_t::OBJECT; }
+inline bool json_is_integer(const json_t* j) { return j && j->kind == json_t::INTEGER; }
+inline bool json_is_number(const json_t* j) { return j && (j->kind == json_t::INTEGER || j->kind == json_t::REAL); }
+inline int json_object_set_new(json_t* o, const char* key, json_t* value) {
+    if (!json_is_object(o) || !value)
+        return -1;
+    for (auto& entry : o->object) {
+        if (entry.first == key) {
+            entry.second = value;
+            return 0;
+        }
+    }
+    o->object.push_back(std::make_pair(std::string(key), value));
+    return 0;
+}
+inline json_t* json_object_get(const json_t* o, const char* key) {
+    if (!json_is_object(o))
+        return nullptr;
+    for (const auto& entry : o->object) {
+        if (entry.first == key)
+            return entry.second;
+    }
+    return nullptr;
+}
+inline json_t* json_integer(long long v) { json_t* j = new json_t(json_t::INTEGER); j->integer = v; return j; }
+inline json_t* json_real(double v) { json_t* j = new json_t(json_t::REAL); j->real = v; return j; }
+inline json_t* json_boolean(bool v) { json_t* j = new json_t(json_t::BOOLEAN); j->integer = v; return j; }
+inline json_t* json_string(const char* v) { json_t* j = new json_t(json_t::STRING); j->string = v; return j; }
+inline long long json_integer_value(const json_t* j) { return json_is_integer(j) ? j->integer : 0; }
+inline double json_real_value(const json_t* j) { return j && j->kind == json_t::REAL ? j->real : 0.0; }
+inline double json_number_value(const json_t* j) { return json_is_integer(j) ? (double)j->integer : json_real_value(j); }
+inline bool json_boolean_value(const json_t* j) { return j && j->kind == json_t::BOOLEAN && j->integer; }
+inline const char* json_string_value(const json_t* j) { return j && j->kind == json_t::STRING ? j->string.c_str() : nullptr; }
+inline int json_array_append_new(json_t* a, json_t* value) {
+    if (!json_is_array(a) || !value)
+        return -1;
+    a->array.push_back(value);
+    return 0;
+}
+inline size_t json_array_size(const json_t* a) { return json_is_array(a) ? a->array.size() : 0; }
+inline json_t* json_array_get(const json_t* a, size_t i) { return i < json_array_size(a) ? a->array[i] : nullptr; }
+#define json_array_foreach(array, index, value) for (index = 0; index < json_array_size(array) && (value = json_array_get(array, index)); index++)
+
+// Draw calls are recorded, not rendered
+struct NVGcontext {
+    long paths = 0;     // nvgBeginPath
+    long vertices = 0;  // Points added by moveTo/lineTo, 4 per rect or circle
+    long fills = 0;
+    long strokes = 0;
+    long texts = 0;
+};
+struct NVGcolor { float r, g, b, a; };
+struct NVGpaint { float xform[6]; };
+struct NVGLUframebuffer { NVGcontext* ctx; unsigned fbo, rbo, texture; int image; };
+inline NVGLUframebuffer* nvgluCreateFramebuffer(NVGcontext* ctx, int, int, int) { return new NVGLUframebuffer{ctx, 0, 0, 0, 1}; }
+inline void nvgluBindFramebuffer(NVGLUframebuffer*) {}
+inline void nvgluDeleteFramebuffer(NVGLUframebuffer* fb) { delete fb; }
+inline void nvgBeginFrame(NVGcontext*, float, float, float) {}
+inline void nvgEndFrame(NVGcontext*) {}
+inline void nvgCurrentTransform(NVGcontext*, float* x) { x[0] = 1; x[1] = 0; x[2] = 0; x[3] = 1; x[4] = 0; x[5] = 0; }
+#define GL_COLOR_BUFFER_BIT 0x4000
+#define GL_STENCIL_BUFFER_BIT 0x400
+inline void glViewport(int, int, int, int) {}
+inline void glClearColor(float, float, float, float) {}
+inline void glClear(unsigned) {}
+enum { NVG_ALIGN_LEFT = 1, NVG_ALIGN_CENTER = 2, NVG_ALIGN_RIGHT = 4, NVG_ALIGN_TOP = 8, NVG_ALIGN_MIDDLE = 16, NVG_ALIGN_BOTTOM = 32, NVG_ALIGN_BASELINE = 64 };
+enum { NVG_ROUND = 1, NVG_BUTT = 0, NVG_SQUARE = 2, NVG_BEVEL = 3, NVG_MITER = 4 };
+enum { NVG_IMAGE_GENERATE_MIPMAPS = 1, NVG_IMAGE_FLIPY = 8, NVG_IMAGE_PREMULTIPLIED = 16, NVG_IMAGE_NEAREST = 32 };
+enum NVGcompositeOperation { NVG_SOURCE_OVER, NVG_SOURCE_IN, NVG_SOURCE_OUT, NVG_ATOP, NVG_DESTINATION_OVER, NVG_DESTINATION_IN, NVG_DESTINATION_OUT, NVG_DESTINATION_ATOP, NVG_LIGHTER, NVG_COPY, NVG_XOR };
+inline NVGcolor nvgRGB(unsigned char r, unsigned char g, unsigned char b) { return {r / 255.f, g / 255.f, b / 255.f, 1.f}; }
+inline NVGcolor nvgRGBA(unsigned char r, unsigned char g, unsigned char b, unsigned char a) { return {r / 255.f, g / 255.f, b / 255.f, a / 255.f}; }
+inline NVGcolor nvgRGBAf(float r, float g, float b, float a) { return {r, g, b, a}; }
+inline NVGcolor nvgRGBf(float r, float g, float b) { return {r, g, b, 1.f}; }
+inline NVGcolor nvgTransRGBAf(NVGcolor c, float a) { c.a = a; return c; }
+inline void nvgBeginPath(NVGcontext* vg) { vg->paths++; }
+inline void nvgMoveTo(NVGcontext* vg, float, float) { vg->vertices++; }
+inline void nvgLineTo(NVGcontext* vg, float, float) { vg->vertices++; }
+inline void nvgRect(NVGcontext* vg, float, float, float, float) { vg->vertices += 4; }
+inline void nvgCircle(NVGcontext* vg, float, float, float) { vg->vertices += 4; }
+inline void nvgFill(NVGcontext* vg) { vg->fills++; }
+inline void nvgStroke(NVGcontext* vg) { vg->strokes++; }
+inline void nvgFillColor(NVGcontext*, NVGcolor) {}
+inline void nvgStrokeColor(NVGcontext*, NVGcolor) {}
+inline void nvgStrokeWidth(NVGcontext*, float) {}
+inline void nvgFillPaint(NVGcontext*, NVGpaint) {}
+inline void nvgSave(NVGcontext*) {}
+inline void nvgRestore(NVGcontext*) {}
+inline void nvgScissor(NVGcontext*, float, float, float, float) {}
+inline void nvgFontSize(NVGcontext*, float) {}
+inline void nvgFontFaceId(NVGcontext*, int) {}
+inline void nvgTextAlign(NVGcontext*, int) {}
+inline float nvgText(NVGcontext* vg, float, float, const char*, const char*) { vg->texts++; return 0; }
+inline int nvgCreateImage(NVGcontext*, const char*, int) { return 1; }
+inline int nvgCreateImageRGBA(NVGcontext*, int, int, int, const unsigned char*) { return 1; }
+inline void nvgUpdateImage(NVGcontext*, int, const unsigned char*) {}
+inline void nvgDeleteImage(NVGcontext*, int) {}
+inline NVGpaint nvgImagePattern(NVGcontext*, float, float, float, float, float, int, float) { return {}; }
+inline void nvgLineCap(NVGcontext*, int) {}
+inline void nvgLineJoin(NVGcontext*, int) {}
+inline void nvgGlobalAlpha(NVGcontext*, float) {}
+inline void nvgGlobalCompositeOperation(NVGcontext*, int) {}
+inline void nvgTranslate(NVGcontext*, float, float) {}
+inline void nvgScale(NVGcontext*, float, float) {}
+inline void nvgResetTransform(NVGcontext*) {}
+
+namespace rack {
+
+namespace math {
+inline float clamp(float x, float a = 0.f, float b = 1.f) { return std::fmax(std::fmin(x, b), a); }
+inline int clamp(int x, int a, int b) { return std::max(std::min(x, b), a); }
+
+inline float rescale(float x, float a, float b, float c, float d) { return c + (x - a) / (b - a) * (d - c); }
+inline float crossfade(float a, float b, float p) { return a + (b - a) * p; }
+inline bool isNear(float a, float b, float eps = 1e-6f) { return std::fabs(a - b) <= eps; }
+struct Vec {
+    float x = 0.f, y = 0.f;
+    Vec() {}
+    Vec(float x, float y) : x(x), y(y) {}
+    Vec plus(Vec b) const { return Vec(x + b.x, y + b.y); }
+    Vec minus(Vec b) const { return Vec(x - b.x, y - b.y); }
+    Vec mult(float s) const { return Vec(x * s, y * s); }
+    Vec div(float s) const { return Vec(x / s, y / s); }
+    bool equals(Vec b) const { return x == b.x && y == b.y; }
+};
+struct Rect {
+    Vec pos, size;
+    Rect() {}
+    Rect(Vec p, Vec s) : pos(p), size(s) {}
+    Rect(float a, float b, float c, float d) : pos(a, b), size(c, d) {}
+    Rect zeroPos() const { return Rect(Vec(), size); }
+};
+}
+using namespace math;
+
+inline float mm2px(float mm) { return mm * 75.f / 25.4f; }
+inline Vec mm2px(Vec mm) { return Vec(mm2px(mm.x), mm2px(mm.y)); }
+static const float RACK_GRID_WIDTH = 15.f;
+static const float RACK_GRID_HEIGHT = 380.f;
+
+namespace random {
+inline void init() {}
+inline float uniform() { return (float)std::rand() / RAND_MAX; }
+inline float normal() { return uniform() - 0.5f; }
+inline uint32_t u32() { return (uint32_t)std::rand(); }
+inline uint64_t u64() { return ((uint64_t)std::rand() << 32) | std::rand(); }
+}
+
+namespace system {
+inline double getTime() { return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+inline bool exists(const std::string& p) { struct stat st; return ::stat(p.c_str(), &st) == 0; }
+inline bool isFile(const std::string& p) { struct stat st; return ::stat(p.c_str(), &st) == 0 && S_ISREG(st.st_mode); }
+inline bool createDirectories(const std::string& p) {
+    for (size_t i = 1; i <= p.size(); i++) {
+        if (i == p.size() || p[i] == '/')
+            ::mkdir(p.substr(0, i).c_str(), 0755);
+    }
+    return exists(p);
+}
+inline bool rename(const std::string& a, const std::string& b) { return std::rename(a.c_str(), b.c_str()) == 0; }
+inline bool remove(const std::string& p) { return std::remove(p.c_str()) == 0; }
+inline std::string getDirectory(const std::string& p) { size_t i = p.rfind('/'); return i == std::string::npos ? "" : p.substr(0, i); }
+inline std::string getFilename(const std::string& p) { size_t i = p.rfind('/'); return i == std::string::npos ? p : p.substr(i + 1); }
+inline std::string join(const std::string& a, const std::string& b) { return a + "/" + b; }
+inline void setThreadName(const std::string&) {}
+inline std::string getTempDirectory() { return "/tmp"; }
+}
+
+namespace string {
+inline std::string f(const char* fmt, ...) { return fmt; }
+}
+
+namespace logger {}
+#define INFO(...) ((void)0)
+#define WARN(...) ((void)0)
+#define DEBUG(...) ((void)0)
+
+namespace simd {
+struct float_4 {
+    union { __m128 v; float s[4]; };
+    float_4() {}
+    float_4(__m128 v) : v(v) {}
+    float_4(float x) { v = _mm_set1_ps(x); }
+    float_4(float a, float b, float c, float d) { v = _mm_setr_ps(a, b, c, d); }
+    static float_4 zero() { return float_4(_mm_setzero_ps()); }
+    static float_4 mask() { return float_4(_mm_castsi128_ps(_mm_set1_epi32(-1))); }
+    static float_4 load(const float* x) { return float_4(_mm_loadu_ps(x)); }
+    void store(float* x) { _mm_storeu_ps(x, v); }
+    float& operator[](int i) { return s[i]; }
+    const float& operator[](int i) const { return s[i]; }
+};
+inline float_4 operator+(float_4 a, float_4 b) { return float_4(_mm_add_ps(a.v, b.v)); }
+inline float_4 operator-(float_4 a, float_4 b) { return float_4(_mm_sub_ps(a.v, b.v)); }
+inline float_4 operator*(float_4 a, float_4 b) { return float_4(_mm_mul_ps(a.v, b.v)); }
+inline float_4 operator/(float_4 a, float_4 b) { return float_4(_mm_div_ps(a.v, b.v)); }
+inline float_4 operator-(float_4 a) { return float_4(0.f) - a; }
+inline float_4 operator+(float_4 a, float b) { return a + float_4(b); }
+inline float_4 operator-(float_4 a, float b) { return a - float_4(b); }
+inline float_4 operator*(float_4 a, float b) { return a * float_4(b); }
+inline float_4 operator/(float_4 a, float b) { return a / float_4(b); }
+inline float_4 operator+(float a, float_4 b) { return float_4(a) + b; }
+inline float_4 operator-(float a, float_4 b) { return float_4(a) - b; }
+inline float_4 operator*(float a, float_4 b) { return float_4(a) * b; }
+inline float_4 operator/(float a, float_4 b) { return float_4(a) / b; }
+inline float_4& operator+=(float_4& a, float_4 b) { return a = a + b; }
+inline float_4& operator-=(float_4& a, float_4 b) { return a = a - b; }
+inline float_4& operator*=(float_4& a, float_4 b) { return a = a * b; }
+inline float_4 operator&(float_4 a, float_4 b) { return float_4(_mm_and_ps(a.v, b.v)); }
+inline float_4 operator|(float_4 a, float_4 b) { return float_4(_mm_or_ps(a.v, b.v)); }
+inline float_4 operator^(float_4 a, float_4 b) { return float_4(_mm_xor_ps(a.v, b.v)); }
+inline float_4 operator~(float_4 a) { return a ^ float_4::mask(); }
+inline float_4 operator==(float_4 a, float_4 b) { return float_4(_mm_cmpeq_ps(a.v, b.v)); }
+inline float_4 operator!=(float_4 a, float_4 b) { return float_4(_mm_cmpneq_ps(a.v, b.v)); }
+inline float_4 operator<(float_4 a, float_4 b) { return float_4(_mm_cmplt_ps(a.v, b.v)); }
+inline float_4 operator>(float_4 a, float_4 b) { return float_4(_mm_cmpgt_ps(a.v, b.v)); }
+inline float_4 operator<=(float_4 a, float_4 b) { return float_4(_mm_cmple_ps(a.v, b.v)); }
+inline float_4 operator>=(float_4 a, float_4 b) { return float_4(_mm_cmpge_ps(a.v, b.v)); }
+inline float_4 ifelse(float_4 m, float_4 a, float_4 b) { return float_4(_mm_blendv_ps(b.v, a.v, m.v)); }
+inline float_4 fmin(float_4 a, float_4 b) { return float_4(_mm_min_ps(a.v, b.v)); }
+inline float_4 fmax(float_4 a, float_4 b) { return float_4(_mm_max_ps(a.v, b.v)); }
+inline float_4 abs(float_4 a) { return float_4(_mm_andnot_ps(_mm_set1_ps(-0.f), a.v)); }
+inline float_4 sqrt(float_4 a) { return float_4(_mm_sqrt_ps(a.v)); }
+inline float_4 floor(float_4 a) { return float_4(_mm_floor_ps(a.v)); }
+inline float_4 round(float_4 a) { return float_4(_mm_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)); }
+inline float_4 sin(float_4 a) { return float_4(std::sin(a.s[0]), std::sin(a.s[1]), std::sin(a.s[2]), std::sin(a.s[3])); }
+inline float_4 cos(float_4 a) { return float_4(std::cos(a.s[0]), std::cos(a.s[1]), std::cos(a.s[2]), std::cos(a.s[3])); }
+inline float_4 clamp(float_4 x, float_4 a, float_4 b) { return fmin(fmax(x, a), b); }
+inline int movemask(float_4 a) { return _mm_movemask_ps(a.v); }
+}
+
+namespace dsp {
+struct SchmittTrigger {
+    bool state = true;
+    void reset() { state = true; }
+    bool process(float in, float lowThreshold = 0.f, float highThreshold = 1.f) {
+        if (state) { if (in <= lowThreshold) state = false; }
+        else if (in >= highThreshold) { state = true; return true; }
+        return false;
+    }
+};
+struct ClockDivider {
+    uint32_t clock = 0, division = 1;
+    void setDivision(uint32_t d) { division = d; }
+    bool process() { if (++clock >= division) { clock = 0; return true; } return false; }
+};
+template <typename T, size_t S>
+struct RingBuffer {
+    std::atomic<size_t> start{0}, end{0};
+    T data[S];
+    void push(T t) { size_t i = end % S; data[i] = t; end++; }
+    T shift() { size_t i = start % S; T t = data[i]; start++; return t; }
+    bool empty() const { return start == end; }
+    bool full() const { return end - start >= S; }
+    size_t size() const { return end - start; }
+    size_t capacity() const { return S - size(); }
+};
+}
+
+namespace plugin { struct Model; }
+namespace engine {
+struct Param {
+    float value = 0.f;
+    float getValue() { return value; }
+    void setValue(float v) { value = v; }
+};
+static const int PORT_MAX_CHANNELS = 16;
+struct Port {
+    float voltages[PORT_MAX_CHANNELS] = {};
+    uint8_t channels = 0;
+    bool connected = false;
+    bool isConnected() { return connected; }
+    int getChannels() { return channels; }
+    void setChannels(int c) { channels = c; }
+    float getVoltage(int c = 0) { return voltages[c]; }
+    float getPolyVoltage(int c) { return channels == 1 ? voltages[0] : voltages[c]; }
+    float getNormalVoltage(float n, int c = 0) { return connected ? voltages[c] : n; }
+    void setVoltage(float v, int c = 0) { voltages[c] = v; }
+    simd::float_4 getVoltageSimd(int c) { return simd::float_4::load(&voltages[c]); }
+    void setVoltageSimd(simd::float_4 v, int c) { v.store(&voltages[c]); }
+};
+struct Engine { float sampleRate = 48000.f; float getSampleRate() { return sampleRate; } };
+struct Input : Port {};
+struct Output : Port {};
+struct Light { float value = 0.f; void setBrightness(float b) { value = b; } };
+struct ParamQuantity {
+    std::string name, unit, description;
+    virtual ~ParamQuantity() {}
+    virtual std::string getDisplayValueString() { return ""; }
+    virtual std::string getString() { return ""; }
+};
+struct PortInfo { std::string name, description; virtual ~PortInfo() {} virtual std::string getDescription() { return description; } };
+struct SwitchQuantity : ParamQuantity {};
+struct Module {
+    struct Expander {
+        int64_t moduleId = -1;
+        Module* module = nullptr;
+        void* producerMessage = nullptr;
+        void* consumerMessage = nullptr;
+        bool messageFlipRequested = false;
+        void requestMessageFlip() { messageFlipRequested = true; }
+    };
+    int64_t id = 0;
+    std::vector<Param> params;
+    std::vector<Input> inputs;
+    std::vector<Output> outputs;
+    std::vector<Light> lights;
+    std::vector<ParamQuantity*> paramQuantities;
+    std::vector<PortInfo*> inputInfos, outputInfos;
+    Expander leftExpander, rightExpander;
+    plugin::Model* model = nullptr;
+    struct ProcessArgs { float sampleRate; float sampleTime; int64_t frame; };
+    struct SampleRateChangeEvent { float sampleRate; float sampleTime; };
+    struct ResetEvent {};
+    struct RandomizeEvent {};
+    struct AddEvent {};
+    struct RemoveEvent {};
+    struct ExpanderChangeEvent { uint8_t side; };
+    virtual ~Module() {}
+    void config(int p, int i, int o, int l) {
+        params.resize(p); inputs.resize(i); outputs.resize(o); lights.resize(l);
+        paramQuantities.resize(p); inputInfos.resize(i); outputInfos.resize(o);
+    }
+    template <class TParamQuantity = ParamQuantity>
+    TParamQuantity* configParam(int id, float, float, float def, std::string name = "", std::string unit = "", float = 0.f, float = 1.f, float = 0.f) {
+        params[id].value = def; auto* q = new TParamQuantity; q->name = name; q->unit = unit; paramQuantities[id] = q; return q;
+    }
+    template <class TSwitchQuantity = SwitchQuantity>
+    TSwitchQuantity* configSwitch(int id, float, float, float def, std::string name = "", std::vector<std::string> = {}) {
+        params[id].value = def; auto* q = new TSwitchQuantity; q->name = name; paramQuantities[id] = q; return q;
+    }
+    template <class TSwitchQuantity = SwitchQuantity>
+    TSwitchQuantity* configButton(int id, std::string name = "") { auto* q = new TSwitchQuantity; q->name = name; paramQuantities[id] = q; return q; }
+    template <class TPortInfo = PortInfo>
+    TPortInfo* configInput(int id, std::string name = "") { auto* q = new TPortInfo; q->name = name; inputInfos[id] = q; return q; }
+    template <class TPortInfo = PortInfo>
+    TPortInfo* configOutput(int id, std::string name = "") { auto* q = new TPortInfo; q->name = name; outputInfos[id] = q; return q; }
+    void configBypass(int, int) {}
+    virtual void process(const ProcessArgs&) {}
+    virtual json_t* dataToJson() { return nullptr; }
+    virtual void dataFromJson(json_t*) {}
+    virtual void onReset(const ResetEvent&) {}
+    virtual void onRandomize(const RandomizeEvent&) {}
+    virtual void onAdd(const AddEvent&) {}
+    virtual void onRemove(const RemoveEvent&) {}
+    virtual void onSampleRateChange(const SampleRateChangeEvent&) {}
+    virtual void onExpanderChange(const ExpanderChangeEvent&) {}
+};
+}
+using namespace engine;
+
+namespace window {
+struct Font { int handle = 0; };
+struct Svg { static std::shared_ptr<Svg> load(const std::string&) { return std::make_shared<Svg>(); } };
+struct Window { NVGcontext* vg = new NVGcontext; NVGcontext* fbVg = new NVGcontext; std::shared_ptr<Font> uiFont = std::make_shared<Font>(); double getLastFrameDuration() { return 1 / 60.0; } double getFrameTime() { return 0; } };
+}
+using namespace window;
+
+namespace widget {
+struct Widget {
+    Rect box;
+    Widget* parent = nullptr;
+    std::vector<Widget*> children;
+    bool visible = true;
+    struct DrawArgs { NVGcontext* vg = nullptr; Rect clipBox; NVGLUframebuffer* fb = nullptr; };
+    virtual ~Widget() {
+        for (Widget* child : children) {
+            delete child;
+        }
+    }
+    virtual void step() {
+        for (Widget* child : children) {
+            child->step();
+        }
+    }
+    virtual void draw(const DrawArgs& args) {
+        for (Widget* child : children) {
+            if (child->visible)
+                child->draw(args);
+        }
+    }
+    virtual void drawLayer(const DrawArgs&, int) {}
+    void addChild(Widget* w) { w->parent = this; children.push_back(w); }
+    struct HoverEvent {}; struct ButtonEvent { int button = 0, action = 0, mods = 0; Vec pos; void consume(Widget*) const {} };
+    struct DragStartEvent { int button = 0; };
+    struct EnterEvent {}; struct LeaveEvent {};
+    struct ContextCreateEvent { NVGcontext* vg; }; struct ContextDestroyEvent { NVGcontext* vg; };
+    virtual void onContextCreate(const ContextCreateEvent&) {}
+    virtual void onContextDestroy(const ContextDestroyEvent&) {}
+    virtual void onButton(const ButtonEvent&) {}
+    virtual void onDragStart(const DragStartEvent&) {}
+    virtual void onEnter(const EnterEvent&) {}
+    virtual void onLeave(const LeaveEvent&) {}
+    template <class T> T* getAncestorOfType() { return nullptr; }
+};
+struct FramebufferWidget : Widget {
+    bool dirty = true;
+    bool bypassed = false;
+    float oversample = 1.f;
+    void setDirty(bool d = true) { dirty = d; }
+    virtual void drawFramebuffer() {}
+    // Renders the children into the framebuffer context when dirty, then paints the image
+    void draw(const DrawArgs& args) override;
+};
+struct SvgWidget : Widget {};
+struct TransparentWidget : Widget {};
+struct OpaqueWidget : Widget {};
+}
+using namespace widget;
+
+namespace ui {
+struct MenuItem : widget::Widget { std::string text, rightText; bool disabled = false; virtual void onAction() {} virtual Widget* createChildMenu() { return nullptr; } };
+struct Menu : widget::Widget {};
+struct MenuSeparator : widget::Widget {};
+struct MenuLabel : MenuItem {};
+struct Tooltip : widget::Widget { std::string text; };
+}
+using namespace ui;
+
+namespace plugin {
+struct Model;
+struct Plugin { void addModel(Model*) {} };
+struct Model { std::string slug; };
+}
+using plugin::Plugin;
+using plugin::Model;
+
+namespace asset {
+inline std::string plugin(Plugin*, const std::string& f) { return f; }
+inline std::string system(const std::string& f) { return f; }
+// Keeps the benchmark's cache files out of the real Rack user folder
+inline std::string user(const std::string& f) { return "/tmp/strangeweather-bench/" + f; }
+}
+
+namespace app {
+struct ModuleWidget : widget::Widget {
+    engine::Module* module = nullptr;
+    void setModule(engine::Module* m) { module = m; }
+    void setPanel(widget::Widget*) {}
+    void addParam(widget::Widget* w) { addChild(w); }
+    void addInput(widget::Widget* w) { addChild(w); }
+    void addOutput(widget::Widget* w) { addChild(w); }
+    virtual void appendContextMenu(ui::Menu*) {}
+    void step() override {}
+};
+struct ParamWidget : widget::OpaqueWidget { engine::Module* module = nullptr; int paramId = 0; };
+struct PortWidget : widget::OpaqueWidget { engine::Module* module = nullptr; int portId = 0; };
+struct SvgSwitch : ParamWidget {
+    struct Shadow { float opacity = 1.f; };
+    Shadow* shadow = new Shadow;
+    bool momentary = false;
+    void addFrame(std::shared_ptr<window::Svg>) {}
+    void onDragStart(const DragStartEvent&) override {}
+};
+struct SvgKnob : ParamWidget {};
+struct SvgPort : PortWidget {};
+struct SvgScrew : widget::Widget {};
+struct SvgPanel : widget::Widget {};
+struct Scene { widget::Widget* rack; };
+struct App { window::Window* window = new window::Window; engine::Engine* engine = new engine::Engine; };
+}
+using namespace app;
+inline app::App* appGet() { static app::App a; return &a; }
+#define APP rack::appGet()
+
+inline void widget::FramebufferWidget::draw(const DrawArgs& args) {
+    if (dirty) {
+        DrawArgs fbArgs = args;
+        fbArgs.vg = APP->window->fbVg;
+        fbArgs.clipBox = box.zeroPos();
+        Widget::draw(fbArgs);
+        dirty = false;
+    }
+    nvgBeginPath(args.vg);
+    nvgRect(args.vg, 0.f, 0.f, box.size.x, box.size.y);
+    nvgFill(args.vg);
+}
+
+namespace componentlibrary {
+struct Davies1900hBlackKnob : app::SvgKnob {};
+struct Trimpot : app::SvgKnob {};
+struct PJ301MPort : app::SvgPort {};
+struct CKSSThree : app::SvgSwitch {};
+struct ScrewSilver : app::SvgScrew {};
+}
+using namespace componentlibrary;
+
+template <class T> T* createWidget(Vec pos) { T* w = new T; w->box.pos = pos; return w; }
+template <class T> T* createParamCentered(Vec pos, engine::Module* m, int id) { T* w = new T; w->box.pos = pos; w->module = m; w->paramId = id; return w; }
+template <class T> T* createOutputCentered(Vec pos, engine::Module* m, int id) { T* w = new T; w->box.pos = pos; w->module = m; w->portId = id; return w; }
+template <class T> T* createInputCentered(Vec pos, engine::Module* m, int id) { T* w = new T; w->box.pos = pos; w->module = m; w->portId = id; return w; }
+inline widget::Widget* createPanel(const std::string&) { return new widget::Widget; }
+inline ui::MenuLabel* createMenuLabel(const std::string& t) { auto* m = new ui::MenuLabel; m->text = t; return m; }
+inline ui::MenuItem* createMenuItem(const std::string& t, const std::string& r = "", std::function<void()> = nullptr, bool = false) { auto* m = new ui::MenuItem; m->text = t; m->rightText = r; return m; }
+inline ui::MenuItem* createIndexSubmenuItem(const std::string& t, std::vector<std::string>, std::function<size_t()>, std::function<void(size_t)>, bool = false) { auto* m = new ui::MenuItem; m->text = t; return m; }
+template <typename T>
+ui::MenuItem* createIndexPtrSubmenuItem(const std::string& t, std::vector<std::string>, T*) { auto* m = new ui::MenuItem; m->text = t; return m; }
+inline ui::MenuItem* createBoolMenuItem(const std::string& t, const std::string&, std::function<bool()>, std::function<void(bool)>, bool = false) { auto* m = new ui::MenuItem; m->text = t; return m; }
+template <typename T>
+ui::MenuItem* createBoolPtrMenuItem(const std::string& t, const std::string&, T*) { auto* m = new ui::MenuItem; m->text = t; return m; }
+inline ui::MenuItem* createSubmenuItem(const std::string& t, const std::string&, std::function<void(ui::Menu*)>, bool = false) { auto* m = new ui::MenuItem; m->text = t; return m; }
+inline ui::MenuItem* createCheckMenuItem(const std::string& t, const std::string&, std::function<bool()>, std::function<void()>, bool = false) { auto* m = new ui::MenuItem; m->text = t; return m; }
+
+template <class TModule, class TModuleWidget>
+plugin::Model* createModel(const std::string& slug) { auto* m = new plugin::Model; m->slug = slug; return m; }
+
+}
@@ -0,0 +1,515 @@
+#pragma once
+#include "plugin.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+struct AttractorOrbit;
+
+// Attractor types
+enum AttractorType {
+    SPROTT_B = 0,
+    ROSSLER = 1,
+    THOMAS = 2,
+    DADRAS = 3
+};
+
+// Attractor equations as compile-time policies. Each kernel's derivatives are templated
+// on the value type, so the same equations serve the scalar Attractor (double) and the
+// lane engine (double_4). Params holds the chaos-dependent constants, computed once per
+// step rather than on every derivative evaluation. A new attractor needs a kernel, an
+// AttractorType entry and a case in Attractor::stepperFor, Attractor::advanceAdaptive
+// and AttractorLanes::integrate.
+struct SprottBKernel {
+    // Error tolerance for the adaptive integrator (relative to the orbit's scale)
+    static double tolerance() { return 1e-5; }
+
+    template <typename T>
+    struct Params {
+        Params(const T& chaos) {}
+    };
+
+    template <typename T>
+    static void derivatives(const T& x, const T& y, const T& z, const Params<T>& p, T& dx, T& dy, T& dz) {
+        // Sprott B - minimal chaotic system, no tunable parameters
+        dx = y * z;
+        dy = x - y;
+        dz = 1.0 - x * y;
+    }
+};
+
+struct RosslerKernel {
+    // a = 0.2, b = 0.2, c varies in the classic chaotic window ~5.7-7.0
+    static double tolerance() { return 1e-5; }
+
+    template <typename T>
+    struct Params {
+        T c;
+        // Staying near the canonical c=5.7 avoids runaway excursions that draw as a box
+        Params(const T& chaos) : c(5.7 + chaos * 1.3) {}  // chaos: classic → slightly wilder but still bounded
+    };
+
+    template <typename T>
+    static void derivatives(const T& x, const T& y, const T& z, const Params<T>& p, T& dx, T& dy, T& dz) {
+        const double a = 0.2;
+        const double b = 0.2;
+        dx = -y - z;
+        dy = x + a * y;
+        dz = b + z * (x - p.c);
+    }
+};
+
+// Fast sine for any value type with floor(): reduced by multiples of pi to
+// [-pi/2, pi/2], then a degree 9 odd minimax polynomial. Within 3.4e-9 of std::sin plus
+// rounding (T's), for the arguments an attractor can reach before its blow-up guard.
+template <typename T>
+inline T fastSin(const T& x) {
+    using std::floor;
+    T k = floor(x * 0.31830988618379067154 + 0.5);
+    T r = x - k * 3.14159265358979323846;
+    T odd = k * 0.5 - floor(k * 0.5);  // 0.5 when k is odd, where the sign flips
+    T r2 = r * r;
+    T p = r * (0.999999976589883 + r2 * (-0.1666664763464029 + r2 * (0.008332899823360418 +
+              r2 * (-0.00019800897763281068 + r2 * 2.590488501433902e-06))));
+    return p - 4.0 * odd * p;
+}
+
+// FAST swaps std::sin for fastSin, which is several times cheaper and, Thomas being
+// chaotic, diverges from the exact trajectory within a few orbits like any other change
+// in rounding would
+template <bool FAST>
+struct TThomasKernel {
+    // b must be < 0.208186 for chaos! Range: 0.19 down to 0.1
+    static double tolerance() { return 1e-5; }
+
+    template <typename T>
+    struct Params {
+        T b;
+        Params(const T& chaos) : b(0.19 - chaos * 0.09) {}  // chaos: mild → wild (always chaotic)
+    };
+
+    template <typename T>
+    static void derivatives(const T& x, const T& y, const T& z, const Params<T>& p, T& dx, T& dy, T& dz) {
+        dx = sine(y) - p.b * x;
+        dy = sine(z) - p.b * y;
+        dz = sine(x) - p.b * z;
+    }
+
+    template <typename T>
+    static T sine(const T& v) {
+        using std::sin;
+        return FAST ? fastSin(v) : sin(v);
+    }
+};
+
+typedef TThomasKernel<false> ThomasKernel;
+typedef TThomasKernel<true> FastThomasKernel;
+
+struct DadrasKernel {
+    // Dadras attractor - multi-wing dynamics
+    // Tighter tolerance: the fast z contraction (e = 9) is where fixed steps blow up
+    static double tolerance() { return 1e-6; }
+
+    template <typename T>
+    struct Params {
+        T c;
+        Params(const T& chaos) : c(1.7 + chaos * 0.6) {}  // chaos varies c for different dynamics
+    };
+
+    template <typename T>
+    static void derivatives(const T& x, const T& y, const T& z, const Params<T>& p, T& dx, T& dy, T& dz) {
+        const double a = 3.0;
+        const double b = 2.7;
+        const double d = 2.0;
+        const double e = 9.0;
+        dx = y - a * x + b * y * z;
+        dy = p.c * y - x * z + z;
+        dz = d * x * y - e * z;
+    }
+};
+
+// Attractor state and parameters
+struct Attractor {
+    double x, y, z;
+    AttractorType type;
+    float chaos = 0.5f; // 0-1, controls primary chaos parameter
+
+    // RK4 stepper specialized for the current type (kept in sync by resetState)
+    typedef void (Attractor::*StepFn)(double dt);
+    StepFn stepFn = &Attractor::stepKernel<SprottBKernel>;
+
+    // Bounding box tracking for normalization
+    double minX, maxX, minY, maxY, minZ, maxZ;
+
+    // When deferReseed is set, a blow-up keeps the last finite state and raises
+    // needsReseed instead of re-seeding inline, so the owner can run the warmup
+    // off the audio thread (see AttractorSeeder)
+    bool deferReseed = false;
+    bool needsReseed = false;
+    // Runaways caught while integrating, for the owner to collect and clear
+    uint32_t blowups = 0;
+
+    // Adaptive integrator state: the step size carried over between calls, and the
+    // derivative at the end of the last accepted step (first-same-as-last), valid while
+    // the state, type and chaos it was evaluated for are unchanged
+    double adaptiveH = 0.01;
+    double fsalX = 0.0, fsalY = 0.0, fsalZ = 0.0;
+    double fsalDx = 0.0, fsalDy = 0.0, fsalDz = 0.0;
+    AttractorType fsalType = SPROTT_B;
+    float fsalChaos = -1.f;
+
+    // Table playback: while orbit is set, the state is read from that precomputed orbit
+    // at orbitPhase (see AttractorOrbitTable) instead of being integrated
+    const AttractorOrbit* orbit = nullptr;
+    double orbitPhase = 0.0;
+
+        double boundLimit() const {
+            switch (type) {
+                case SPROTT_B: return 5.0;  // Sprott B is compact
+                case ROSSLER: return 35.0;
+                case THOMAS: return 8.0;
+                case DADRAS: return 15.0;  // Tighter bounds for stability
+            }
+        return 35.0;
+        }
+
+    void finalizeBounds() {
+        double lim = boundLimit();
+        auto clampTo = [lim](double& vmin, double& vmax) {
+            vmin = std::max(vmin, -lim);
+            vmax = std::min(vmax, lim);
+            if (vmax - vmin < 1e-3) {
+                vmin -= 1.0;
+                vmax += 1.0;
+            }
+        };
+        clampTo(minX, maxX);
+        clampTo(minY, maxY);
+        clampTo(minZ, maxZ);
+    }
+
+    // Default-constructed attractors are unseeded (a valid point near the Sprott B orbit
+    // with placeholder bounds); call resetState() to put them onto their attractor
+    Attractor() {
+        type = SPROTT_B;
+        x = y = z = 0.1;
+        minX = minY = minZ = -1.0;
+        maxX = maxY = maxZ = 1.0;
+    }
+
+    // Blow-up guard: non-finite or too large
+    // Use tighter threshold (1000) to catch runaway before it causes issues
+    static bool isRunaway(double x, double y, double z) {
+        return !std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z) ||
+            std::abs(x) > 1000.0 || std::abs(y) > 1000.0 || std::abs(z) > 1000.0;
+    }
+
+    // Reset state to good initial conditions for current attractor type. Picks a settled
+    // state from the shared seed cache, falling back to a full warmup before it's built.
+    void resetState() {
+        stepFn = stepperFor(type);
+        needsReseed = false;
+        orbit = nullptr;
+        if (!seedFromCache()) {
+            warmupFromScratch();
+        }
+    }
+
+    // Defined in AttractorSeedCache.cpp
+    bool seedFromCache();
+
+    // Start playing `table` from its point nearest the current state, taking its bounds.
+    // Clearing orbit hands the state back to integration, which carries on from there.
+    // Defined in AttractorOrbitTable.cpp
+    void startOrbit(const AttractorOrbit* table);
+    // Advance table playback by `span` time units
+    void playOrbit(double span);
+
+    // Integrate from a fixed starting point until the state settles onto the attractor
+    void warmupFromScratch() {
+        // The warmup itself always recovers inline, and its recoveries aren't counted
+        bool defer = deferReseed;
+        deferReseed = false;
+        uint32_t counted = blowups;
+        // Each attractor has different scale/basin - use appropriate initial conditions
+        int warmupSteps = 0;
+        double warmupDt = 0.0;
+        switch (type) {
+            case SPROTT_B:
+                // Sprott B - compact attractor, start near origin
+                x = 0.1 + (random::uniform() - 0.5) * 0.1;
+                y = 0.1 + (random::uniform() - 0.5) * 0.1;
+                z = 0.1 + (random::uniform() - 0.5) * 0.1;
+                minX = maxX = x;
+                minY = maxY = y;
+                minZ = maxZ = z;
+                warmupSteps = 2000; warmupDt = 0.01;
+                break;
+            case ROSSLER:
+                // Rossler orbits around origin; use a tiny asymmetry to avoid the trivial zero orbit
+                x = 0.1 + (random::uniform() - 0.5) * 0.02;
+                y = 0.1 + (random::uniform() - 0.5) * 0.02;
+                z = 0.0 + (random::uniform() - 0.5) * 0.02;
+                minX = maxX = x;
+                minY = maxY = y;
+                minZ = maxZ = z;
+                warmupSteps = 2000; warmupDt = 0.01;
+                break;
+            case THOMAS:
+                // Thomas is bounded roughly [-5, 5], needs asymmetric start to avoid fixed points
+                x = 1.0 + (random::uniform() - 0.5) * 0.5;
+                y = 1.1 + (random::uniform() - 0.5) * 0.5;
+                z = 1.2 + (random::uniform() - 0.5) * 0.5;
+                minX = maxX = x;
+                minY = maxY = y;
+                minZ = maxZ = z;
+                warmupSteps = 1500; warmupDt = 0.01;
+                break;
+            case DADRAS:
+                // Dadras: start near attractor basin
+                x = 1.0 + (random::uniform() - 0.5) * 0.2;
+                y = 1.0 + (random::uniform() - 0.5) * 0.2;
+                z = 1.0 + (random::uniform() - 0.5) * 0.2;
+                minX = maxX = x;
+                minY = maxY = y;
+                minZ = maxZ = z;
+                warmupSteps = 2000; warmupDt = 0.01;
+                break;
+        }
+        if (warmupSteps > 0 && warmupDt > 0.0) {
+            warmup(warmupSteps, warmupDt);
+            // Add a tiny perturbation and short settle to avoid periodic lock-in
+            x += (random::uniform() - 0.5) * 0.01;
+            y += (random::uniform() - 0.5) * 0.01;
+            z += (random::uniform() - 0.5) * 0.01;
+            warmup(500, warmupDt);
+            // Keep bounds from warmup but clamp to reasonable span
+            finalizeBounds();
+        }
+        deferReseed = defer;
+        blowups = counted;
+    }
+
+    // Set type and reset state if type changed
+    void setType(AttractorType newType) {
+        if (newType != type) {
+            type = newType;
+            resetState();
+        }
+    }
+
+    // Run a short, fixed warmup so the attractor settles into its orbit immediately
+    void warmup(int steps, double dt) {
+        for (int i = 0; i < steps; i++) {
+            step(dt);
+        }
+    }
+
+    static StepFn stepperFor(AttractorType t) {
+        switch (t) {
+            case SPROTT_B: return &Attractor::stepKernel<SprottBKernel>;
+            case ROSSLER: return &Attractor::stepKernel<RosslerKernel>;
+            case THOMAS: return &Attractor::stepKernel<ThomasKernel>;
+            case DADRAS: return &Attractor::stepKernel<DadrasKernel>;
+        }
+        return &Attractor::stepKernel<SprottBKernel>;
+    }
+
+    // RK4 integration step
+    void step(double dt) {
+        (this->*stepFn)(dt);
+    }
+
+    // RK4 integration step for one kernel (chaos affects primary parameter)
+    template <class K>
+    void stepKernel(double dt) {
+        const typename K::template Params<double> p(chaos);
+
+        double k1x, k1y, k1z;
+        double k2x, k2y, k2z;
+        double k3x, k3y, k3z;
+        double k4x, k4y, k4z;
+
+        double ox = x, oy = y, oz = z;
+
+        // k1
+        K::derivatives(ox, oy, oz, p, k1x, k1y, k1z);
+
+        // k2
+        K::derivatives(ox + 0.5 * dt * k1x, oy + 0.5 * dt * k1y, oz + 0.5 * dt * k1z, p, k2x, k2y, k2z);
+
+        // k3
+        K::derivatives(ox + 0.5 * dt * k2x, oy + 0.5 * dt * k2y, oz + 0.5 * dt * k2z, p, k3x, k3y, k3z);
+
+        // k4
+        K::derivatives(ox + dt * k3x, oy + dt * k3y, oz + dt * k3z, p, k4x, k4y, k4z);
+
+        // Final update
+        x = ox + (dt / 6.0) * (k1x + 2.0 * k2x + 2.0 * k3x + k4x);
+        y = oy + (dt / 6.0) * (k1y + 2.0 * k2y + 2.0 * k3y + k4y);
+        z = oz + (dt / 6.0) * (k1z + 2.0 * k2z + 2.0 * k3z + k4z);
+
+        // Blow-up guard: if state became non-finite or too large, re-seed
+        if (recoverRunaway(ox, oy, oz)) {
+            return;  // Keep the runaway state out of the bounds
+        }
+
+        expandBounds();
+    }
+
+    // If the state has blown up, re-seed (or with deferReseed, fall back to the previous
+    // state ox/oy/oz and flag it). Returns true if it had.
+    bool recoverRunaway(double ox, double oy, double oz) {
+        if (!isRunaway(x, y, z))
+            return false;
+        blowups++;
+        if (deferReseed) {
+            x = ox; y = oy; z = oz;
+            needsReseed = true;
+        }
+        else {
+            resetState();
+        }
+        return true;
+    }
+
+    // Update bounding box - expand only
+    void expandBounds() {
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        minZ = std::min(minZ, z);
+        maxZ = std::max(maxZ, z);
+    }
+
+    // Advance by exactly `span` time units with the adaptive integrator. Unlike step(),
+    // there is no fixed substep count: the step size follows the local error. Returns
+    // the number of steps tried, rejected ones included. fastSine selects FastThomasKernel.
+    int advanceAdaptive(double span, bool fastSine = false) {
+        switch (type) {
+            case SPROTT_B: return advanceAdaptiveKernel<SprottBKernel>(span);
+            case ROSSLER: return advanceAdaptiveKernel<RosslerKernel>(span);
+            case THOMAS:
+                return fastSine ? advanceAdaptiveKernel<FastThomasKernel>(span)
+                                : advanceAdaptiveKernel<ThomasKernel>(span);
+            case DADRAS: return advanceAdaptiveKernel<DadrasKernel>(span);
+        }
+        return 0;
+    }
+
+    // Dormand-Prince 5(4) with first-same-as-last: six new derivative evaluations per
+    // step, the 4th-order embedded solution estimates the error and the 5th-order one
+    // is kept. Error is measured per component against tol * (1 + |value|).
+    template <class K>
+    int advanceAdaptiveKernel(double span) {
+        const double minStep = 1e-6;
+        const double maxStep = 0.1;
+        const typename K::template Params<double> p(chaos);
+        const double tol = K::tolerance();
+
+        double k1x, k1y, k1z;
+        if (fsalChaos == chaos && fsalType == type && fsalX == x && fsalY == y && fsalZ == z) {
+            k1x = fsalDx; k1y = fsalDy; k1z = fsalDz;
+        }
+        else {
+            K::derivatives(x, y, z, p, k1x, k1y, k1z);
+        }
+
+        double h = std::min(std::max(adaptiveH, minStep), maxStep);
+        double t = 0.0;
+        int tried = 0;
+        while (t < span) {
+            tried++;
+            // Clip the last step to land exactly on the end of the span
+            bool last = h >= span - t;
+            double hs = last ? span - t : h;
+
+            double k2x, k2y, k2z, k3x, k3y, k3z, k4x, k4y, k4z;
+            double k5x, k5y, k5z, k6x, k6y, k6z, k7x, k7y, k7z;
+            K::derivatives(x + hs * (1.0 / 5.0) * k1x,
+                           y + hs * (1.0 / 5.0) * k1y,
+                           z + hs * (1.0 / 5.0) * k1z, p, k2x, k2y, k2z);
+            K::derivatives(x + hs * (3.0 / 40.0 * k1x + 9.0 / 40.0 * k2x),
+                           y + hs * (3.0 / 40.0 * k1y + 9.0 / 40.0 * k2y),
+                           z + hs * (3.0 / 40.0 * k1z + 9.0 / 40.0 * k2z), p, k3x, k3y, k3z);
+            K::derivatives(x + hs * (44.0 / 45.0 * k1x - 56.0 / 15.0 * k2x + 32.0 / 9.0 * k3x),
+                           y + hs * (44.0 / 45.0 * k1y - 56.0 / 15.0 * k2y + 32.0 / 9.0 * k3y),
+                           z + hs * (44.0 / 45.0 * k1z - 56.0 / 15.0 * k2z + 32.0 / 9.0 * k3z), p, k4x, k4y, k4z);
+            K::derivatives(x + hs * (19372.0 / 6561.0 * k1x - 25360.0 / 2187.0 * k2x + 64448.0 / 6561.0 * k3x - 212.0 / 729.0 * k4x),
+                           y + hs * (19372.0 / 6561.0 * k1y - 25360.0 / 2187.0 * k2y + 64448.0 / 6561.0 * k3y - 212.0 / 729.0 * k4y),
+                           z + hs * (19372.0 / 6561.0 * k1z - 25360.0 / 2187.0 * k2z + 64448.0 / 6561.0 * k3z - 212.0 / 729.0 * k4z), p, k5x, k5y, k5z);
+            K::derivatives(x + hs * (9017.0 / 3168.0 * k1x - 355.0 / 33.0 * k2x + 46732.0 / 5247.0 * k3x + 49.0 / 176.0 * k4x - 5103.0 / 18656.0 * k5x),
+                           y + hs * (9017.0 / 3168.0 * k1y - 355.0 / 33.0 * k2y + 46732.0 / 5247.0 * k3y + 49.0 / 176.0 * k4y - 5103.0 / 18656.0 * k5y),
+                           z + hs * (9017.0 / 3168.0 * k1z - 355.0 / 33.0 * k2z + 46732.0 / 5247.0 * k3z + 49.0 / 176.0 * k4z - 5103.0 / 18656.0 * k5z), p, k6x, k6y, k6z);
+
+            // 5th-order solution
+            double nx = x + hs * (35.0 / 384.0 * k1x + 500.0 / 1113.0 * k3x + 125.0 / 192.0 * k4x - 2187.0 / 6784.0 * k5x + 11.0 / 84.0 * k6x);
+            double ny = y + hs * (35.0 / 384.0 * k1y + 500.0 / 1113.0 * k3y + 125.0 / 192.0 * k4y - 2187.0 / 6784.0 * k5y + 11.0 / 84.0 * k6y);
+            double nz = z + hs * (35.0 / 384.0 * k1z + 500.0 / 1113.0 * k3z + 125.0 / 192.0 * k4z - 2187.0 / 6784.0 * k5z + 11.0 / 84.0 * k6z);
+            K::derivatives(nx, ny, nz, p, k7x, k7y, k7z);
+
+            // Difference to the embedded 4th-order solution
+            double ex = hs * (71.0 / 57600.0 * k1x - 71.0 / 16695.0 * k3x + 71.0 / 1920.0 * k4x - 17253.0 / 339200.0 * k5x + 22.0 / 525.0 * k6x - 1.0 / 40.0 * k7x);
+            double ey = hs * (71.0 / 57600.0 * k1y - 71.0 / 16695.0 * k3y + 71.0 / 1920.0 * k4y - 17253.0 / 339200.0 * k5y + 22.0 / 525.0 * k6y - 1.0 / 40.0 * k7y);
+            double ez = hs * (71.0 / 57600.0 * k1z - 71.0 / 16695.0 * k3z + 71.0 / 1920.0 * k4z - 17253.0 / 339200.0 * k5z + 22.0 / 525.0 * k6z - 1.0 / 40.0 * k7z);
+            ex /= tol * (1.0 + std::max(std::abs(x), std::abs(nx)));
+            ey /= tol * (1.0 + std::max(std::abs(y), std::abs(ny)));
+            ez /= tol * (1.0 + std::max(std::abs(z), std::abs(nz)));
+            double err = std::sqrt((ex * ex + ey * ey + ez * ez) / 3.0);
+            // A non-finite error means the trial step blew up: shrink as hard as allowed
+            if (!std::isfinite(err))
+                err = 1e10;
+
+            // Standard step-size controller, growth and shrink limited per step
+            double factor = (err > 0.0) ? 0.9 * std::pow(err, -0.2) : 5.0;
+            factor = std::min(std::max(factor, 0.2), 5.0);
+
+            bool accept = err <= 1.0 || hs <= minStep;
+            if (accept) {
+                double ox = x, oy = y, oz = z;
+                x = nx; y = ny; z = nz;
+                if (recoverRunaway(ox, oy, oz)) {
+                    adaptiveH = 0.01;
+                    return tried;
+                }
+                expandBounds();
+                k1x = k7x; k1y = k7y; k1z = k7z;
+                t = last ? span : t + hs;
+                // A step clipped short by the span end says little about the next one
+                h = last ? std::max(h, hs * factor) : hs * factor;
+            }
+            else {
+                h = hs * factor;
+            }
+            h = std::min(std::max(h, minStep), maxStep);
+        }
+
+        adaptiveH = h;
+        fsalX = x; fsalY = y; fsalZ = z;
+        fsalDx = k1x; fsalDy = k1y; fsalDz = k1z;
+        fsalType = type;
+        fsalChaos = chaos;
+        return tried;
+    }
+
+    // Get normalized outputs (-5V to +5V)
+    float getNormX() {
+        double range = maxX - minX;
+        if (range < 0.001) range = 0.001;
+        return (float)(((x - minX) / range) * 10.0 - 5.0);
+    }
+    
+    float getNormY() {
+        double range = maxY - minY;
+        if (range < 0.001) range = 0.001;
+        return (float)(((y - minY) / range) * 10.0 - 5.0);
+    }
+    
+    float getNormZ() {
+        double range = maxZ - minZ;
+        if (range < 0.001) range = 0.001;
+        return (float)(((z - minZ) / range) * 10.0 - 5.0);
+    }
+};
@@ -0,0 +1,375 @@
+#pragma once
+#include "Attractor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+
+// Four double-precision lanes. Rack's simd:: only provides float lanes, so this mirrors
+// the float_4 interface (arithmetic, masks, ifelse) closely enough for the batch
+// integrator. The fixed-size loops vectorize to SSE2/AVX at -O3. No over-alignment:
+// modules are allocated with plain operator new, which doesn't honour it in C++11.
+struct double_4 {
+    double s[4];
+
+    double_4() {}
+    double_4(double x) {
+        for (int i = 0; i < 4; i++) s[i] = x;
+    }
+    double_4(double a, double b, double c, double d) {
+        s[0] = a; s[1] = b; s[2] = c; s[3] = d;
+    }
+    double& operator[](int i) { return s[i]; }
+    const double& operator[](int i) const { return s[i]; }
+};
+
+// Per-lane selection mask for double_4 (all bits set = lane selected)
+struct double_4_mask {
+    int64_t s[4];
+};
+
+#define DOUBLE_4_OP(op) \
+    inline double_4 operator op(const double_4& a, const double_4& b) { \
+        double_4 r; \
+        for (int i = 0; i < 4; i++) r.s[i] = a.s[i] op b.s[i]; \
+        return r; \
+    } \
+    inline double_4 operator op(const double_4& a, double b) { \
+        double_4 r; \
+        for (int i = 0; i < 4; i++) r.s[i] = a.s[i] op b; \
+        return r; \
+    } \
+    inline double_4 operator op(double a, const double_4& b) { \
+        double_4 r; \
+        for (int i = 0; i < 4; i++) r.s[i] = a op b.s[i]; \
+        return r; \
+    }
+DOUBLE_4_OP(+)
+DOUBLE_4_OP(-)
+DOUBLE_4_OP(*)
+DOUBLE_4_OP(/)
+#undef DOUBLE_4_OP
+
+inline double_4 operator-(const double_4& a) {
+    double_4 r;
+    for (int i = 0; i < 4; i++) r.s[i] = -a.s[i];
+    return r;
+}
+
+inline double_4_mask operator==(const double_4& a, const double_4& b) {
+    double_4_mask r;
+    for (int i = 0; i < 4; i++) r.s[i] = (a.s[i] == b.s[i]) ? -1 : 0;
+    return r;
+}
+
+inline double_4 ifelse(const double_4_mask& m, const double_4& a, const double_4& b) {
+    double_4 r;
+    for (int i = 0; i < 4; i++) r.s[i] = m.s[i] ? a.s[i] : b.s[i];
+    return r;
+}
+
+inline double_4 fmin(const double_4& a, const double_4& b) {
+    double_4 r;
+    for (int i = 0; i < 4; i++) r.s[i] = std::min(a.s[i], b.s[i]);
+    return r;
+}
+
+inline double_4 fmax(const double_4& a, const double_4& b) {
+    double_4 r;
+    for (int i = 0; i < 4; i++) r.s[i] = std::max(a.s[i], b.s[i]);
+    return r;
+}
+
+inline double_4 floor(const double_4& a) {
+    double_4 r;
+    for (int i = 0; i < 4; i++) r.s[i] = std::floor(a.s[i]);
+    return r;
+}
+
+inline double_4 sin(const double_4& a) {
+    double_4 r;
+    for (int i = 0; i < 4; i++) r.s[i] = std::sin(a.s[i]);
+    return r;
+}
+
+
+// Per-precision details of the lane engine. Float lanes integrate an offset from the
+// state each batch starts at rather than the state itself: at low rates a per-sample
+// increment is far below one float ulp of the state and would round away, while the
+// offset starts at zero and keeps it. The offset is added to the Attractor's double
+// state when the batch is scattered back.
+template <typename V>
+struct AttractorLaneTraits;
+
+template <>
+struct AttractorLaneTraits<double_4> {
+    static const bool RELATIVE = false;
+};
+
+template <>
+struct AttractorLaneTraits<simd::float_4> {
+    static const bool RELATIVE = true;
+};
+
+
+// Structure-of-arrays RK4 integrator that steps up to four Attractors together, in
+// double (AttractorLanes, the reference) or float (AttractorLanesFloat) lanes.
+// When every lane runs the same AttractorType (always the case within a poly bank) the
+// RK4 loop is generated for that type's kernel alone. Batches mixing types evaluate
+// each type present across all lanes and blend it in with a per-lane mask; types no
+// lane uses are skipped. The Attractor objects remain the canonical state; they are
+// gathered into lanes before integrating and scattered back afterwards.
+template <typename V>
+struct TAttractorLanes {
+    typedef decltype(V() == V()) Mask;
+    static const bool RELATIVE = AttractorLaneTraits<V>::RELATIVE;
+    static const int LANES = 4;
+    // Largest RK4 step every kernel stays stable at
+    static constexpr double MAX_STEP = 0.01;
+    // Run Thomas with FastThomasKernel instead of ThomasKernel (std::sin)
+    bool fastSine = false;
+
+    V x, y, z;           // State, or the offset from origin with RELATIVE lanes
+    V originX, originY, originZ;
+    V minX, maxX, minY, maxY, minZ, maxZ;
+
+    // Chaos-dependent constants, computed once per batch
+    V chaos;
+    Mask typeMask[4];
+    bool typePresent[4];
+
+    // Point the state (or offset) p stands for
+    static V position(const V& origin, const V& p) {
+        return RELATIVE ? origin + p : p;
+    }
+
+    // Derivatives of a single kernel for all lanes
+    template <class K>
+    struct KernelDerivatives {
+        typename K::template Params<V> p;
+        const V& originX;
+        const V& originY;
+        const V& originZ;
+        KernelDerivatives(const TAttractorLanes& lanes)
+            : p(lanes.chaos), originX(lanes.originX), originY(lanes.originY), originZ(lanes.originZ) {}
+        void operator()(const V& px, const V& py, const V& pz, V& dx, V& dy, V& dz) const {
+            K::derivatives(position(originX, px), position(originY, py), position(originZ, pz), p, dx, dy, dz);
+        }
+    };
+
+    // Derivatives of a batch mixing several types, blended per lane
+    struct MixedDerivatives {
+        const Mask* typeMask;
+        const bool* typePresent;
+        bool fastSine;
+        KernelDerivatives<SprottBKernel> sprottB;
+        KernelDerivatives<RosslerKernel> rossler;
+        KernelDerivatives<ThomasKernel> thomas;
+        KernelDerivatives<FastThomasKernel> fastThomas;
+        KernelDerivatives<DadrasKernel> dadras;
+
+        MixedDerivatives(const TAttractorLanes& lanes)
+            : typeMask(lanes.typeMask), typePresent(lanes.typePresent), fastSine(lanes.fastSine),
+              sprottB(lanes), rossler(lanes), thomas(lanes), fastThomas(lanes), dadras(lanes) {}
+
+        template <class D>
+        void blend(const D& deriv, AttractorType t, const V& px, const V& py, const V& pz,
+                   V& dx, V& dy, V& dz) const {
+            if (!typePresent[t])
+                return;
+            V kx, ky, kz;
+            deriv(px, py, pz, kx, ky, kz);
+            dx = ifelse(typeMask[t], kx, dx);
+            dy = ifelse(typeMask[t], ky, dy);
+            dz = ifelse(typeMask[t], kz, dz);
+        }
+
+        void operator()(const V& px, const V& py, const V& pz, V& dx, V& dy, V& dz) const {
+            dx = dy = dz = V(0.0);
+            blend(sprottB, SPROTT_B, px, py, pz, dx, dy, dz);
+            blend(rossler, ROSSLER, px, py, pz, dx, dy, dz);
+            if (fastSine)
+                blend(fastThomas, THOMAS, px, py, pz, dx, dy, dz);
+            else
+                blend(thomas, THOMAS, px, py, pz, dx, dy, dz);
+            blend(dadras, DADRAS, px, py, pz, dx, dy, dz);
+        }
+    };
+
+    // Bounds are expanded after every substep when trackBounds is set
+    template <class D>
+    void rk4(const D& deriv, const V& h, int steps, bool trackBounds) {
+        const V halfH = h * 0.5;
+        const V sixthH = h / 6.0;
+        V k1x, k1y, k1z, k2x, k2y, k2z, k3x, k3y, k3z, k4x, k4y, k4z;
+
+        for (int s = 0; s < steps; s++) {
+            deriv(x, y, z, k1x, k1y, k1z);
+            deriv(x + halfH * k1x, y + halfH * k1y, z + halfH * k1z, k2x, k2y, k2z);
+            deriv(x + halfH * k2x, y + halfH * k2y, z + halfH * k2z, k3x, k3y, k3z);
+            deriv(x + h * k3x, y + h * k3y, z + h * k3z, k4x, k4y, k4z);
+
+            x = x + sixthH * (k1x + 2.0 * k2x + 2.0 * k3x + k4x);
+            y = y + sixthH * (k1y + 2.0 * k2y + 2.0 * k3y + k4y);
+            z = z + sixthH * (k1z + 2.0 * k2z + 2.0 * k3z + k4z);
+
+            if (!trackBounds)
+                continue;
+            // Update bounding box - expand only
+            V px = position(originX, x), py = position(originY, y), pz = position(originZ, z);
+            minX = fmin(minX, px);
+            maxX = fmax(maxX, px);
+            minY = fmin(minY, py);
+            maxY = fmax(maxY, py);
+            minZ = fmin(minZ, pz);
+            maxZ = fmax(maxZ, pz);
+        }
+    }
+
+    // Run `points` spans of `steps` substeps each, storing the state normalized to the
+    // bounds (-1 to 1) after every span when out is set
+    template <class D>
+    void run(const D& deriv, const V& h, int steps, int points, float* out, bool trackBounds) {
+        if (!out) {
+            rk4(deriv, h, steps, trackBounds);
+            return;
+        }
+        for (int p = 0; p < points; p++) {
+            rk4(deriv, h, steps, trackBounds);
+            V nx = (position(originX, x) - minX) / fmax(maxX - minX, V(0.001)) * 2.0 - 1.0;
+            V ny = (position(originY, y) - minY) / fmax(maxY - minY, V(0.001)) * 2.0 - 1.0;
+            V nz = (position(originZ, z) - minZ) / fmax(maxZ - minZ, V(0.001)) * 2.0 - 1.0;
+            float* point = out + p * 3 * LANES;
+            for (int i = 0; i < LANES; i++) {
+                point[i] = (float)nx[i];
+                point[LANES + i] = (float)ny[i];
+                point[2 * LANES + i] = (float)nz[i];
+            }
+        }
+    }
+
+    // Integrate `count` (1-4) attractors, each over its own time span dt[i], using
+    // `steps` RK4 substeps for every lane (lanes needing fewer steps just take finer ones).
+    // Without trackBounds the attractors' bounds are left as they are, for owners that
+    // normalize by other means (see BoundsWindow).
+    void integrate(Attractor* const* attractors, int count, const double* dt, int steps, bool trackBounds = true) {
+        batch(attractors, count, dt, steps, 1, nullptr, trackBounds);
+    }
+
+    // Audio-rate path: integrate `count` (1-4) attractors for `points` consecutive spans
+    // of dt[i] each, in `steps` substeps per span, writing their normalized state after
+    // every span to out as [point][x, y, z][lane]. Unused lanes hold padding.
+    void render(Attractor* const* attractors, int count, const double* dt, int steps, int points, float* out) {
+        batch(attractors, count, dt, steps, points, out, true);
+    }
+
+    // Gather a batch into the lanes, run it and scatter it back
+    void batch(Attractor* const* attractors, int count, const double* dt, int steps, int points, float* out,
+               bool trackBounds) {
+        V h, typeLane;
+        int numTypes = 0;
+        for (int t = 0; t < 4; t++) {
+            typePresent[t] = false;
+        }
+        for (int i = 0; i < LANES; i++) {
+            // Pad unused lanes with a copy of lane 0; their results are discarded
+            const Attractor& a = *attractors[i < count ? i : 0];
+            if (RELATIVE) {
+                originX[i] = a.x; originY[i] = a.y; originZ[i] = a.z;
+                x[i] = y[i] = z[i] = 0.0;
+            }
+            else {
+                x[i] = a.x; y[i] = a.y; z[i] = a.z;
+            }
+            minX[i] = a.minX; maxX[i] = a.maxX;
+            minY[i] = a.minY; maxY[i] = a.maxY;
+            minZ[i] = a.minZ; maxZ[i] = a.maxZ;
+            h[i] = (i < count ? dt[i] : dt[0]) / steps;
+            chaos[i] = a.chaos;
+            typeLane[i] = a.type;
+            if (!typePresent[a.type]) {
+                typePresent[a.type] = true;
+                numTypes++;
+            }
+        }
+
+        if (numTypes == 1) {
+            switch (attractors[0]->type) {
+                case SPROTT_B: run(KernelDerivatives<SprottBKernel>(*this), h, steps, points, out, trackBounds); break;
+                case ROSSLER: run(KernelDerivatives<RosslerKernel>(*this), h, steps, points, out, trackBounds); break;
+                case THOMAS:
+                    if (fastSine)
+                        run(KernelDerivatives<FastThomasKernel>(*this), h, steps, points, out, trackBounds);
+                    else
+                        run(KernelDerivatives<ThomasKernel>(*this), h, steps, points, out, trackBounds);
+                    break;
+                case DADRAS: run(KernelDerivatives<DadrasKernel>(*this), h, steps, points, out, trackBounds); break;
+            }
+        }
+        else {
+            for (int t = 0; t < 4; t++) {
+                typeMask[t] = (typeLane == V(t));
+            }
+            run(MixedDerivatives(*this), h, steps, points, out, trackBounds);
+        }
+
+        for (int i = 0; i < count; i++) {
+            Attractor& a = *attractors[i];
+            double nx = RELATIVE ? a.x + x[i] : x[i];
+            double ny = RELATIVE ? a.y + y[i] : y[i];
+            double nz = RELATIVE ? a.z + z[i] : z[i];
+            // Same blow-up guard as Attractor::step, checked once per batch
+            bool runaway = Attractor::isRunaway(nx, ny, nz);
+            if (runaway) {
+                a.blowups++;
+            }
+            if (runaway && a.deferReseed) {
+                // Leave the Attractor at its state from before the batch
+                a.needsReseed = true;
+                continue;
+            }
+            a.x = nx; a.y = ny; a.z = nz;
+            // Float bounds are rounded; merging keeps them from ever shrinking
+            a.minX = std::min(a.minX, (double)minX[i]); a.maxX = std::max(a.maxX, (double)maxX[i]);
+            a.minY = std::min(a.minY, (double)minY[i]); a.maxY = std::max(a.maxY, (double)maxY[i]);
+            a.minZ = std::min(a.minZ, (double)minZ[i]); a.maxZ = std::max(a.maxZ, (double)maxZ[i]);
+            if (runaway) {
+                a.resetState();
+            }
+        }
+    }
+
+    // Fast-forward `count` attractors (any number), each by its own span (time units),
+    // in MAX_STEP steps with bounds tracking and nothing else: for catching up or
+    // pre-rolling outside process(), typically on a worker thread. The blow-up guard
+    // runs between chunks of CHUNK_STEPS; an attractor with deferReseed stops at its
+    // blow-up with needsReseed set.
+    void advance(Attractor* const* attractors, int count, const double* spans) {
+        const long CHUNK_STEPS = 256;
+        for (int b = 0; b < count; b += LANES) {
+            int n = std::min(LANES, count - b);
+            double longest = *std::max_element(spans + b, spans + b + n);
+            long total = (long)std::ceil(longest / MAX_STEP);
+            for (long done = 0; done < total; done += CHUNK_STEPS) {
+                int steps = (int)std::min(CHUNK_STEPS, total - done);
+                Attractor* group[LANES];
+                double dt[LANES];
+                int live = 0;
+                for (int i = b; i < b + n; i++) {
+                    if (attractors[i]->needsReseed)
+                        continue;
+                    group[live] = attractors[i];
+                    dt[live] = spans[i] * steps / total;
+                    live++;
+                }
+                if (live == 0)
+                    break;
+                integrate(group, live, dt, steps);
+            }
+        }
+    }
+};
+
+typedef TAttractorLanes<double_4> AttractorLanes;
+typedef TAttractorLanes<simd::float_4> AttractorLanesFloat;
@@ -0,0 +1,355 @@
+#include "AttractorOrbitTable.hpp"
+#include "AttractorSeedCache.hpp"
+#include "CacheFile.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+
+namespace {
+
+AttractorOrbit orbits[4][AttractorSeedCache::CHAOS_BUCKETS];
+std::mutex buildMutex;
+std::once_flag loadOnce;
+std::atomic<bool> built(false);
+
+// Cache file layout: one Record per orbit, in orbits[][] order, then all the points
+const char* FILE_NAME = "orbits.bin";
+// Bump whenever the kernels, the recording parameters or the layout change
+const uint32_t FILE_VERSION = 1;
+
+struct Record {
+    uint64_t offset;  // First point, counted from the start of the points
+    uint64_t length;
+    double step;
+    double minX, maxX, minY, maxY, minZ, maxZ;
+};
+
+const int NUM_ORBITS = 4 * AttractorSeedCache::CHAOS_BUCKETS;
+
+// Each orbit is recorded for MAX_POINTS points and looped at its closest return after
+// MIN_POINTS; the gap left at the seam is spread over the last SEAM_POINTS
+const int MIN_POINTS = 8192;
+const int MAX_POINTS = 16384;
+const int SEAM_POINTS = 1024;
+const double MAX_SUBSTEP = 0.01;  // Largest RK4 step between points, as in the lane engine
+
+// Time between points per type, about 1-3% of the orbit's extent each, so the
+// interpolation stays smooth and the slow Thomas orbit still loops over a long stretch
+double orbitStep(AttractorType type) {
+    switch (type) {
+        case SPROTT_B: return 0.01;
+        case ROSSLER: return 0.01;
+        case THOMAS: return 0.05;
+        case DADRAS: return 0.0025;
+    }
+    return 0.01;
+}
+
+double distance(const AttractorOrbit& orbit, const AttractorOrbit::Point& p, double x, double y, double z) {
+    double dx = (p.x - x) / (orbit.maxX - orbit.minX);
+    double dy = (p.y - y) / (orbit.maxY - orbit.minY);
+    double dz = (p.z - z) / (orbit.maxZ - orbit.minZ);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Index cell of (x, y, z), clamped to the grid; returns the squared distance from the
+// cell's centre, in cells
+double cellOf(const AttractorOrbit& orbit, double x, double y, double z, int* cell) {
+    const int G = AttractorOrbit::INDEX_CELLS;
+    const double u[3] = {(x - orbit.minX) / (orbit.maxX - orbit.minX) * G,
+                         (y - orbit.minY) / (orbit.maxY - orbit.minY) * G,
+                         (z - orbit.minZ) / (orbit.maxZ - orbit.minZ) * G};
+    double offset = 0.0;
+    for (int k = 0; k < 3; k++) {
+        cell[k] = clamp((int)std::floor(u[k]), 0, G - 1);
+        double d = u[k] - (cell[k] + 0.5);
+        offset += d * d;
+    }
+    return offset;
+}
+
+void record(Attractor& a, double step, std::vector<AttractorOrbit::Point>& points) {
+    int substeps = (int)std::ceil(step / MAX_SUBSTEP);
+    points.resize(MAX_POINTS);
+    for (int i = 0; i < MAX_POINTS; i++) {
+        a.warmup(substeps, step / substeps);
+        points[i].x = a.x;
+        points[i].y = a.y;
+        points[i].z = a.z;
+    }
+}
+
+void buildOrbit(AttractorType type, int bucket) {
+    Attractor a;
+    a.type = type;
+    a.chaos = (float)bucket / (AttractorSeedCache::CHAOS_BUCKETS - 1);
+    a.stepFn = Attractor::stepperFor(type);
+    a.warmupFromScratch();
+
+    // A run that blew up was re-seeded part way and would loop across the jump
+    AttractorOrbit& orbit = orbits[type][bucket];
+    std::vector<AttractorOrbit::Point>& points = orbit.storage;
+    orbit.step = orbitStep(type);
+    const int maxAttempts = 4;
+    for (int attempt = 0; attempt < maxAttempts; attempt++) {
+        uint32_t blowups = a.blowups;
+        record(a, orbit.step, points);
+        if (a.blowups == blowups)
+            break;
+    }
+
+    // Bounds over the recorded run, clamped like an integrated attractor's
+    a.minX = a.maxX = points[0].x;
+    a.minY = a.maxY = points[0].y;
+    a.minZ = a.maxZ = points[0].z;
+    for (const AttractorOrbit::Point& p : points) {
+        a.minX = std::min(a.minX, (double)p.x); a.maxX = std::max(a.maxX, (double)p.x);
+        a.minY = std::min(a.minY, (double)p.y); a.maxY = std::max(a.maxY, (double)p.y);
+        a.minZ = std::min(a.minZ, (double)p.z); a.maxZ = std::max(a.maxZ, (double)p.z);
+    }
+    a.finalizeBounds();
+    orbit.minX = a.minX; orbit.maxX = a.maxX;
+    orbit.minY = a.minY; orbit.maxY = a.maxY;
+    orbit.minZ = a.minZ; orbit.maxZ = a.maxZ;
+
+    // Loop where the orbit passes closest to its first two points, so the seam matches in
+    // direction as well as position
+    const AttractorOrbit::Point& p0 = points[0];
+    const AttractorOrbit::Point& p1 = points[1];
+    int length = MIN_POINTS;
+    double best = 1e30;
+    for (int k = MIN_POINTS; k < MAX_POINTS - 1; k++) {
+        double d = distance(orbit, points[k], p0.x, p0.y, p0.z) +
+                   distance(orbit, points[k + 1], p1.x, p1.y, p1.z);
+        if (d < best) {
+            best = d;
+            length = k;
+        }
+    }
+    float gapX = p0.x - points[length].x;
+    float gapY = p0.y - points[length].y;
+    float gapZ = p0.z - points[length].z;
+    points.resize(length);
+    for (int n = 0; n < SEAM_POINTS; n++) {
+        AttractorOrbit::Point& p = points[length - SEAM_POINTS + n];
+        float w = (float)n / SEAM_POINTS;
+        p.x += gapX * w;
+        p.y += gapY * w;
+        p.z += gapZ * w;
+    }
+    points.shrink_to_fit();
+    orbit.points = points.data();
+    orbit.length = length;
+    orbit.buildIndex();
+}
+
+// Point every orbit into a mapped cache file; false if its layout doesn't check out
+bool adopt(const void* data, size_t size) {
+    if (size < sizeof(Record) * NUM_ORBITS)
+        return false;
+    const Record* records = (const Record*)data;
+    const AttractorOrbit::Point* points = (const AttractorOrbit::Point*)(records + NUM_ORBITS);
+    uint64_t numPoints = (size - sizeof(Record) * NUM_ORBITS) / sizeof(AttractorOrbit::Point);
+    for (int i = 0; i < NUM_ORBITS; i++) {
+        const Record& r = records[i];
+        if (r.length < 4 || r.offset > numPoints || r.length > numPoints - r.offset || !(r.step > 0.0))
+            return false;
+    }
+    for (int i = 0; i < NUM_ORBITS; i++) {
+        const Record& r = records[i];
+        AttractorOrbit& orbit = orbits[i / AttractorSeedCache::CHAOS_BUCKETS][i % AttractorSeedCache::CHAOS_BUCKETS];
+        orbit.points = points + r.offset;
+        orbit.length = (int)r.length;
+        orbit.step = r.step;
+        orbit.minX = r.minX; orbit.maxX = r.maxX;
+        orbit.minY = r.minY; orbit.maxY = r.maxY;
+        orbit.minZ = r.minZ; orbit.maxZ = r.maxZ;
+        orbit.buildIndex();
+    }
+    return true;
+}
+
+void save() {
+    std::vector<Record> records(NUM_ORBITS);
+    uint64_t numPoints = 0;
+    for (int i = 0; i < NUM_ORBITS; i++) {
+        const AttractorOrbit& orbit = orbits[i / AttractorSeedCache::CHAOS_BUCKETS][i % AttractorSeedCache::CHAOS_BUCKETS];
+        Record& r = records[i];
+        r.offset = numPoints;
+        r.length = orbit.length;
+        r.step = orbit.step;
+        r.minX = orbit.minX; r.maxX = orbit.maxX;
+        r.minY = orbit.minY; r.maxY = orbit.maxY;
+        r.minZ = orbit.minZ; r.maxZ = orbit.maxZ;
+        numPoints += orbit.length;
+    }
+    std::vector<uint8_t> payload(sizeof(Record) * NUM_ORBITS + sizeof(AttractorOrbit::Point) * numPoints);
+    std::memcpy(payload.data(), records.data(), sizeof(Record) * NUM_ORBITS);
+    uint8_t* out = payload.data() + sizeof(Record) * NUM_ORBITS;
+    for (int i = 0; i < NUM_ORBITS; i++) {
+        const AttractorOrbit& orbit = orbits[i / AttractorSeedCache::CHAOS_BUCKETS][i % AttractorSeedCache::CHAOS_BUCKETS];
+        std::memcpy(out + sizeof(AttractorOrbit::Point) * records[i].offset, orbit.points,
+                    sizeof(AttractorOrbit::Point) * orbit.length);
+    }
+    CacheFile::write(FILE_NAME, FILE_VERSION, payload.data(), payload.size());
+}
+
+}  // namespace
+
+
+void AttractorOrbit::sample(double phase, double& x, double& y, double& z) const {
+    // Phase is kept in [0, length), so the neighbours only ever wrap by one
+    int n = length;
+    int i = std::min((int)phase, n - 1);
+    float t = (float)(phase - i);
+    int i0 = (i > 0) ? i - 1 : n - 1;
+    int i2 = (i + 1 < n) ? i + 1 : 0;
+    int i3 = (i2 + 1 < n) ? i2 + 1 : 0;
+    const Point& a = points[i0];
+    const Point& b = points[i];
+    const Point& c = points[i2];
+    const Point& d = points[i3];
+    auto catmullRom = [t](float p0, float p1, float p2, float p3) {
+        return p1 + 0.5f * t * (p2 - p0 + t * (2.f * p0 - 5.f * p1 + 4.f * p2 - p3 + t * (3.f * (p1 - p2) + p3 - p0)));
+    };
+    x = catmullRom(a.x, b.x, c.x, d.x);
+    y = catmullRom(a.y, b.y, c.y, d.y);
+    z = catmullRom(a.z, b.z, c.z, d.z);
+}
+
+
+double AttractorOrbit::nearestPhase(double x, double y, double z) const {
+    // The index cell's point is within a cell of the nearest pass; refine along the loop
+    const int window = 8;
+    int n = length;
+    int cell[3];
+    cellOf(*this, x, y, z, cell);
+    int candidate = index[(cell[0] * INDEX_CELLS + cell[1]) * INDEX_CELLS + cell[2]];
+    int best = candidate;
+    double bestDistance = 1e30;
+    for (int i = candidate - window; i <= candidate + window; i++) {
+        int j = (i + n) % n;
+        double d = distance(*this, points[j], x, y, z);
+        if (d < bestDistance) {
+            bestDistance = d;
+            best = j;
+        }
+    }
+    return best;
+}
+
+
+void AttractorOrbit::buildIndex() {
+    const int G = INDEX_CELLS;
+    index.assign(G * G * G, -1);
+    std::vector<double> nearest(G * G * G, 1e30);
+    for (int i = 0; i < length; i++) {
+        const Point& p = points[i];
+        int cell[3];
+        double offset = cellOf(*this, p.x, p.y, p.z, cell);
+        int k = (cell[0] * G + cell[1]) * G + cell[2];
+        if (offset < nearest[k]) {
+            nearest[k] = offset;
+            index[k] = i;
+        }
+    }
+
+    // Grow the filled cells into the empty ones, one layer of face neighbours per pass
+    std::vector<int32_t> previous;
+    bool empty = true;
+    while (empty) {
+        empty = false;
+        previous = index;
+        for (int cx = 0; cx < G; cx++) {
+            for (int cy = 0; cy < G; cy++) {
+                for (int cz = 0; cz < G; cz++) {
+                    int k = (cx * G + cy) * G + cz;
+                    if (previous[k] >= 0)
+                        continue;
+                    const int neighbours[6][3] = {{cx - 1, cy, cz}, {cx + 1, cy, cz}, {cx, cy - 1, cz},
+                                                  {cx, cy + 1, cz}, {cx, cy, cz - 1}, {cx, cy, cz + 1}};
+                    for (const int* c : neighbours) {
+                        if (c[0] < 0 || c[0] >= G || c[1] < 0 || c[1] >= G || c[2] < 0 || c[2] >= G)
+                            continue;
+                        int found = previous[(c[0] * G + c[1]) * G + c[2]];
+                        if (found >= 0) {
+                            index[k] = found;
+                            break;
+                        }
+                    }
+                    empty = empty || index[k] < 0;
+                }
+            }
+        }
+    }
+}
+
+
+void AttractorOrbitTable::load() {
+    std::call_once(loadOnce, []() {
+        {
+            std::lock_guard<std::mutex> lock(buildMutex);
+            if (built.load(std::memory_order_relaxed))
+                return;
+            size_t size = 0;
+            const void* data = CacheFile::map(FILE_NAME, FILE_VERSION, size);
+            if (data && adopt(data, size)) {
+                built.store(true, std::memory_order_release);
+                return;
+            }
+        }
+        // Detached: Rack never unloads plugins, and an unfinished write only leaves a
+        // temporary file behind
+        std::thread([]() {
+            random::init();
+            build();
+            save();
+        }).detach();
+    });
+}
+
+
+void AttractorOrbitTable::build() {
+    std::lock_guard<std::mutex> lock(buildMutex);
+    if (built.load(std::memory_order_relaxed))
+        return;
+    for (int t = 0; t < 4; t++) {
+        for (int bucket = 0; bucket < AttractorSeedCache::CHAOS_BUCKETS; bucket++) {
+            buildOrbit((AttractorType)t, bucket);
+        }
+    }
+    built.store(true, std::memory_order_release);
+}
+
+
+const AttractorOrbit* AttractorOrbitTable::find(AttractorType type, float chaos) {
+    if (!built.load(std::memory_order_acquire))
+        return nullptr;
+    int bucket = (int)std::round(chaos * (AttractorSeedCache::CHAOS_BUCKETS - 1));
+    bucket = clamp(bucket, 0, AttractorSeedCache::CHAOS_BUCKETS - 1);
+    return &orbits[type][bucket];
+}
+
+
+void Attractor::startOrbit(const AttractorOrbit* table) {
+    orbit = table;
+    orbitPhase = table->nearestPhase(x, y, z);
+    table->sample(orbitPhase, x, y, z);
+    minX = table->minX; maxX = table->maxX;
+    minY = table->minY; maxY = table->maxY;
+    minZ = table->minZ; maxZ = table->maxZ;
+}
+
+
+void Attractor::playOrbit(double span) {
+    double length = (double)orbit->length;
+    orbitPhase += span / orbit->step;
+    if (orbitPhase >= length) {
+        orbitPhase = std::fmod(orbitPhase, length);
+    }
+    orbit->sample(orbitPhase, x, y, z);
+}
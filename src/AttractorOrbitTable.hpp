@@ -0,0 +1,56 @@
+#pragma once
+#include "Attractor.hpp"
+
+#include <cstdint>
+#include <vector>
+
+
+// One looped, settled trajectory of an attractor at a fixed chaos setting, sampled every
+// `step` time units. The loop is cut where the orbit comes back closest to its start and
+// the remaining gap is spread over its last stretch, so playback wraps without a jump.
+struct AttractorOrbit {
+    struct Point {
+        float x, y, z;
+    };
+
+    // In `storage` when generated, or in the mapped cache file
+    const Point* points = nullptr;
+    int length = 0;
+    double step = 0.01;
+    double minX, maxX, minY, maxY, minZ, maxZ;
+    std::vector<Point> storage;
+    // Coarse spatial index: a grid of INDEX_CELLS per axis over the bounds, holding for
+    // each cell the point nearest its centre, or for empty cells that of a filled
+    // neighbour. Built off the audio thread along with the points, it keeps joining the
+    // table O(1).
+    static const int INDEX_CELLS = 16;
+    std::vector<int32_t> index;
+
+    // Cubic (Catmull-Rom) interpolation at `phase`, in points from the start of the loop
+    void sample(double phase, double& x, double& y, double& z) const;
+
+    // Phase of a point close to (x, y, z), measured relative to the orbit's bounds: the
+    // index cell's point, refined over its neighbours along the loop
+    double nearestPhase(double x, double y, double z) const;
+
+    // Fill `index` from the points and bounds
+    void buildIndex();
+};
+
+
+// Plugin-wide orbit tables for table playback (see Attractor::playOrbit), one per
+// AttractorType and seed cache chaos bucket, shared read-only by all module instances
+// (about 5 MB in total).
+struct AttractorOrbitTable {
+    // Make the tables available: map them from the cache file, or regenerate them on a
+    // background thread and save them if the file is missing or stale. Call on first use,
+    // from the UI or patch loading.
+    static void load();
+
+    // Build every table now unless they are already available. This integrates every
+    // orbit (a fraction of a second), so never call it from the audio thread.
+    static void build();
+
+    // Table for `type` at the chaos bucket nearest `chaos`, or nullptr until available
+    static const AttractorOrbit* find(AttractorType type, float chaos);
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include "Attractor.hpp"
+
+
+// Plugin-wide table of settled on-attractor states, shared by all module instances.
+// For every AttractorType and chaos bucket it holds a set of points sampled along one
+// long settled trajectory plus that trajectory's converged bounding box, so
+// Attractor::resetState() can pick a seed in O(1) instead of running a warmup, and
+// normalization starts from the full extent of the orbit rather than a partial one.
+struct AttractorSeedCache {
+    static const int CHAOS_BUCKETS = 9;  // chaos 0, 0.125, ..., 1
+    static const int SEEDS_PER_BUCKET = 16;
+
+    // Make the cache available: map it from the cache file, or regenerate it on a
+    // background thread and save it if the file is missing or stale. Until it is ready,
+    // resets fall back to a full warmup. Call from a module constructor.
+    static void load();
+
+    // Fill the cache now unless it is already available. This integrates every bucket
+    // (tens of milliseconds), so never call it from the audio thread.
+    static void build();
+
+    // Whether resets currently take a seed from the cache rather than warming up
+    static bool ready();
+};
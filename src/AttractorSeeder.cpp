@@ -0,0 +1,126 @@
+#include "AttractorSeeder.hpp"
+#include "AttractorLanes.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+namespace {
+
+std::mutex seederMutex;
+std::condition_variable seederCv;
+std::vector<std::shared_ptr<AttractorSeeder::Slots>> registered;
+std::thread seederThread;
+bool seederRunning = false;
+// Bumped for every thread started, so a thread being stopped can't be revived by a
+// registration that arrives before it has exited
+int seederGeneration = 0;
+
+// How often the seeder looks for requests. The audio thread never signals it directly,
+// so this is the worst-case latency before a warmup starts.
+const std::chrono::milliseconds POLL_INTERVAL(2);
+
+void seederRun(int generation) {
+    random::init();
+    std::vector<std::shared_ptr<AttractorSeeder::Slots>> work;
+    std::vector<AttractorSeeder::Slot*> advancing;
+    std::vector<Attractor*> targets;
+    std::vector<double> spans;
+    AttractorLanes lanes;
+    std::unique_lock<std::mutex> lock(seederMutex);
+    while (seederRunning && seederGeneration == generation) {
+        // Hold references so a module removed mid-warmup can't free its slots under us
+        work = registered;
+        lock.unlock();
+
+        for (const std::shared_ptr<AttractorSeeder::Slots>& slots : work) {
+            for (AttractorSeeder::Slot& slot : slots->slots) {
+                if (slot.state.load(std::memory_order_acquire) != AttractorSeeder::REQUESTED)
+                    continue;
+                if (slot.advanceSpan > 0.0) {
+                    // Collected so voices advance together, four lanes at a time
+                    slot.staged.deferReseed = false;
+                    advancing.push_back(&slot);
+                    targets.push_back(&slot.staged);
+                    spans.push_back(slot.advanceSpan);
+                    continue;
+                }
+                slot.staged = Attractor();
+                slot.staged.type = slot.type;
+                slot.staged.chaos = slot.chaos;
+                slot.staged.resetState();
+                slot.state.store(AttractorSeeder::READY, std::memory_order_release);
+            }
+        }
+        if (!advancing.empty()) {
+            lanes.advance(targets.data(), (int)targets.size(), spans.data());
+            for (AttractorSeeder::Slot* slot : advancing) {
+                slot->state.store(AttractorSeeder::READY, std::memory_order_release);
+            }
+        }
+        work.clear();
+        advancing.clear();
+        targets.clear();
+        spans.clear();
+
+        lock.lock();
+        seederCv.wait_for(lock, POLL_INTERVAL);
+    }
+}
+
+}  // namespace
+
+
+void AttractorSeeder::add(const std::shared_ptr<Slots>& slots) {
+    std::lock_guard<std::mutex> lock(seederMutex);
+    registered.push_back(slots);
+    if (!seederRunning) {
+        seederRunning = true;
+        seederGeneration++;
+        seederThread = std::thread(seederRun, seederGeneration);
+    }
+}
+
+
+void AttractorSeeder::remove(const std::shared_ptr<Slots>& slots) {
+    std::thread stopped;
+    {
+        std::lock_guard<std::mutex> lock(seederMutex);
+        registered.erase(std::remove(registered.begin(), registered.end(), slots), registered.end());
+        if (registered.empty() && seederRunning) {
+            seederRunning = false;
+            stopped = std::move(seederThread);
+        }
+    }
+    if (stopped.joinable()) {
+        seederCv.notify_all();
+        stopped.join();
+    }
+}
+
+
+bool AttractorSeeder::requestReseed(Slot& slot, AttractorType type, float chaos) {
+    if (slot.state.load(std::memory_order_acquire) != IDLE)
+        return false;
+    slot.type = type;
+    slot.chaos = chaos;
+    slot.advanceSpan = 0.0;
+    slot.state.store(REQUESTED, std::memory_order_release);
+    return true;
+}
+
+
+bool AttractorSeeder::requestAdvance(Slot& slot, const Attractor& a, double span) {
+    if (slot.state.load(std::memory_order_acquire) != IDLE)
+        return false;
+    slot.type = a.type;
+    slot.chaos = a.chaos;
+    slot.staged = a;
+    slot.staged.orbit = nullptr;  // Advanced by integration, so it leaves any table
+    slot.advanceSpan = span;
+    slot.state.store(REQUESTED, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Attractor.hpp"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+
+// Plugin-wide background thread that runs Attractor warmups and fast-forwards off the
+// audio thread. A module owns a block of slots (one per voice) and registers it here.
+// The audio thread requests a re-seed by filling an idle slot and publishing it as
+// REQUESTED; the seeder warms up a staging Attractor and publishes it as READY; the
+// audio thread takes the staged state and returns the slot to IDLE. An advance request
+// works the same way, except that the audio thread copies the voice into the staging
+// Attractor and the seeder fast-forwards it (see AttractorLanes::advance). Each slot is a single-producer
+// handoff guarded by its atomic state, so the audio side never locks or allocates.
+struct AttractorSeeder {
+    enum SlotState {
+        IDLE,
+        REQUESTED,
+        READY
+    };
+
+    struct Slot {
+        std::atomic<int> state{IDLE};
+        // Written by the audio thread before REQUESTED
+        AttractorType type = SPROTT_B;
+        float chaos = 0.5f;
+        double advanceSpan = 0.0;  // > 0: advance `staged` by this many time units instead
+        // Written by the seeder thread before READY (and by the audio thread to advance)
+        Attractor staged;
+    };
+
+    struct Slots {
+        std::vector<Slot> slots;
+        explicit Slots(int count) : slots(count) {}
+    };
+
+    // The first registration starts the seeder thread and the last removal stops it.
+    // Call from the module constructor/destructor, never from the audio thread.
+    static void add(const std::shared_ptr<Slots>& slots);
+    static void remove(const std::shared_ptr<Slots>& slots);
+
+    // Audio thread: request a re-seed to `type`/`chaos`, or a copy of `a` advanced by
+    // `span` time units. Returns false, requesting nothing, unless the slot is IDLE.
+    static bool requestReseed(Slot& slot, AttractorType type, float chaos);
+    static bool requestAdvance(Slot& slot, const Attractor& a, double span);
+};
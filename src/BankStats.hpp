@@ -0,0 +1,51 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+
+// Runtime counters for one bank. The engine accumulates a window of control frames in
+// the plain fields (audio thread only) and publishes a summary to the atomics at the end
+// of each window; the UI reads them with relaxed loads, so they are cheap enough to be
+// always on.
+struct BankStats {
+    // Published summary
+    std::atomic<float> avgSubsteps{0.f};   // Integration substeps per sample, all voices of the bank
+    std::atomic<float> maxSubsteps{0.f};   // Most substeps per sample in a single control frame
+    std::atomic<uint32_t> capHits{0};      // Voice frames limited by the 100-substep cap (running total)
+    std::atomic<uint32_t> blowups{0};      // Runaway recoveries (running total)
+    std::atomic<float> spanX{0.f}, spanY{0.f}, spanZ{0.f};  // Normalization bounds of channel 1
+    std::atomic<float> nsPerSample{0.f};   // Estimated integration time
+
+    // Current window
+    double steps = 0.0;
+    float peak = 0.f;
+    uint32_t capHitTotal = 0;
+    uint32_t blowupTotal = 0;
+    double timedNs = 0.0;       // Integration time of the sampled frames
+    double timedSamples = 0.0;  // Samples those frames covered
+
+    // Account one control frame covering `samples` samples
+    void addFrame(double frameSteps, int samples) {
+        steps += frameSteps;
+        peak = std::max(peak, (float)(frameSteps / samples));
+    }
+
+    // Publish the window of `samples` samples and start a new one
+    void publish(double samples, float sx, float sy, float sz) {
+        std::memory_order relaxed = std::memory_order_relaxed;
+        avgSubsteps.store((float)(steps / samples), relaxed);
+        maxSubsteps.store(peak, relaxed);
+        capHits.store(capHitTotal, relaxed);
+        blowups.store(blowupTotal, relaxed);
+        spanX.store(sx, relaxed);
+        spanY.store(sy, relaxed);
+        spanZ.store(sz, relaxed);
+        if (timedSamples > 0.0)
+            nsPerSample.store((float)(timedNs / timedSamples), relaxed);
+        steps = 0.0;
+        peak = 0.f;
+        timedNs = 0.0;
+        timedSamples = 0.0;
+    }
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include "Attractor.hpp"
+
+#include <algorithm>
+
+
+// Sliding-window bounds for normalization, an alternative to the expand-only bounds the
+// integrators track, fed one state per control frame. Samples are folded into BLOCKS
+// blocks of equal duration; the window is the last BLOCKS - 1 completed blocks plus the
+// one filling, so an excursion stops counting once it is that old. A sample costs six
+// compares and a completed block one pass over the blocks: O(1) amortized, with no
+// per-sample history to store.
+struct BoundsWindow {
+    static const int BLOCKS = 16;
+    double lo[BLOCKS][3], hi[BLOCKS][3];
+    double pastLo[3], pastHi[3];  // Over the completed blocks in the window
+    int current = 0;              // Block being filled
+    double filled = 0.0;          // Time gathered in it
+    int type = -1;                // AttractorType the window holds (-1 = start over)
+
+    // Start over with every block at the attractor's current bounds, which then age out
+    // over one window
+    void reset(const Attractor& a) {
+        const double aLo[3] = {a.minX, a.minY, a.minZ};
+        const double aHi[3] = {a.maxX, a.maxY, a.maxZ};
+        for (int b = 0; b < BLOCKS; b++) {
+            std::copy(aLo, aLo + 3, lo[b]);
+            std::copy(aHi, aHi + 3, hi[b]);
+        }
+        std::copy(aLo, aLo + 3, pastLo);
+        std::copy(aHi, aHi + 3, pastHi);
+        current = 0;
+        filled = 0.0;
+        type = a.type;
+    }
+
+    // Fold in the state (x, y, z), which stands for `time` of the trajectory, with blocks
+    // of `blockTime` each
+    void push(double x, double y, double z, double time, double blockTime) {
+        const double v[3] = {x, y, z};
+        for (int k = 0; k < 3; k++) {
+            lo[current][k] = std::min(lo[current][k], v[k]);
+            hi[current][k] = std::max(hi[current][k], v[k]);
+        }
+        filled += time;
+        if (filled < blockTime)
+            return;
+        // The oldest block drops out and becomes the new current one
+        filled = std::min(filled - blockTime, blockTime);
+        current = (current + 1) % BLOCKS;
+        for (int k = 0; k < 3; k++) {
+            lo[current][k] = hi[current][k] = v[k];
+            pastLo[k] = pastHi[k] = v[k];
+        }
+        for (int b = 0; b < BLOCKS; b++) {
+            if (b == current)
+                continue;
+            for (int k = 0; k < 3; k++) {
+                pastLo[k] = std::min(pastLo[k], lo[b][k]);
+                pastHi[k] = std::max(pastHi[k], hi[b][k]);
+            }
+        }
+    }
+
+    // Extremes of axis k over the window
+    double low(int k) const {
+        return std::min(pastLo[k], lo[current][k]);
+    }
+
+    double high(int k) const {
+        return std::max(pastHi[k], hi[current][k]);
+    }
+};
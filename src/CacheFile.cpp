@@ -0,0 +1,138 @@
+#include "CacheFile.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined ARCH_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+
+const char MAGIC[8] = {'S', 'W', 'C', 'A', 'C', 'H', 'E', '\0'};
+
+// Map a whole file read-only; returns nullptr if it can't be opened or is empty
+const uint8_t* mapFile(const std::string& path, size_t& size) {
+#if defined ARCH_WIN
+    HANDLE file = CreateFileW(string::UTF8toUTF16(path).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+    LARGE_INTEGER fileSize;
+    const uint8_t* data = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+        size = (size_t)fileSize.QuadPart;
+    }
+    CloseHandle(file);
+    return data;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    struct stat st;
+    const uint8_t* data = nullptr;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* p = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+            data = (const uint8_t*)p;
+        size = (size_t)st.st_size;
+    }
+    ::close(fd);
+    return data;
+#endif
+}
+
+void unmapFile(const uint8_t* data, size_t size) {
+#if defined ARCH_WIN
+    UnmapViewOfFile(data);
+#else
+    ::munmap((void*)data, size);
+#endif
+}
+
+}  // namespace
+
+
+std::string CacheFile::path(const std::string& name) {
+    return asset::user("StrangeWeather/" + name);
+}
+
+
+const void* CacheFile::map(const std::string& name, uint32_t version, size_t& size) {
+    size_t fileSize = 0;
+    const uint8_t* data = mapFile(path(name), fileSize);
+    if (!data)
+        return nullptr;
+
+    Header header;
+    bool valid = fileSize >= sizeof(Header);
+    if (valid) {
+        std::memcpy(&header, data, sizeof(Header));
+        valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                header.version == version &&
+                header.headerSize == sizeof(Header) &&
+                header.payloadSize == fileSize - sizeof(Header) &&
+                header.checksum == checksum(data + sizeof(Header), (size_t)header.payloadSize);
+    }
+    if (!valid) {
+        unmapFile(data, fileSize);
+        return nullptr;
+    }
+    size = (size_t)header.payloadSize;
+    return data + sizeof(Header);
+}
+
+
+bool CacheFile::write(const std::string& name, uint32_t version, const void* payload, size_t size) {
+    std::string target = path(name);
+    system::createDirectories(system::getDirectory(target));
+    // Unique per writer, so two Rack instances regenerating at once don't collide
+    std::string temp = target + ".tmp" + std::to_string(random::u32());
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = version;
+    header.headerSize = sizeof(Header);
+    header.payloadSize = size;
+    header.checksum = checksum(payload, size);
+
+    std::FILE* f = std::fopen(temp.c_str(), "wb");
+    if (!f)
+        return false;
+    bool ok = std::fwrite(&header, sizeof(Header), 1, f) == 1 &&
+              std::fwrite(payload, 1, size, f) == size;
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok || !system::rename(temp, target)) {
+        system::remove(temp);
+        return false;
+    }
+    return true;
+}
+
+
+uint64_t CacheFile::checksum(const void* data, size_t size) {
+    const uint64_t prime = 0x100000001b3ULL;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const uint8_t* bytes = (const uint8_t*)data;
+    size_t words = size / sizeof(uint64_t);
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+        hash = (hash ^ word) * prime;
+    }
+    for (size_t i = words * sizeof(uint64_t); i < size; i++) {
+        hash = (hash ^ bytes[i]) * prime;
+    }
+    return hash;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "plugin.hpp"
+
+#include <cstdint>
+#include <string>
+
+
+// Versioned binary cache files in the plugin's Rack user folder, for tables that are
+// expensive to generate. A file is a small header (magic, format version, payload size
+// and checksum) followed by the payload. Loading memory-maps the file and verifies the
+// header; the mapping stays valid for the life of the process. Writes go to a temporary
+// file that is renamed over the old one, so a reader never sees a partial file.
+struct CacheFile {
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t payloadSize;
+        uint64_t checksum;
+    };
+
+    // Path of cache file `name` (in <Rack user folder>/StrangeWeather)
+    static std::string path(const std::string& name);
+
+    // Map `name` and return its payload, or nullptr if it is missing, has a different
+    // version or fails the checksum. size receives the payload size.
+    static const void* map(const std::string& name, uint32_t version, size_t& size);
+
+    // Replace `name` with the given payload; returns false if it couldn't be written
+    static bool write(const std::string& name, uint32_t version, const void* payload, size_t size);
+
+    // 64-bit FNV-1a over whole words, with the tail bytes folded in last
+    static uint64_t checksum(const void* data, size_t size);
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include "plugin.hpp"
+#include "Attractor.hpp"
+#include "TrailBuffer.hpp"
+
+
+// State Strange Weather publishes every sample to companion modules placed directly to
+// its left or right, through Rack's double-buffered expander messages, so they can use
+// every bank without cables or recomputing anything.
+//
+// A companion derives from StrangeWeatherBus::Consumer as well as Module, and allocates
+// two Messages as the producerMessage and consumerMessage of the expander side facing
+// Strange Weather (leftExpander when it sits on the right). Strange Weather fills the
+// producer message and requests a flip, so the companion reads the previous sample's
+// state from its consumerMessage. Banks a companion reads (see Consumer::busBanks) keep
+// running even when nothing else uses them.
+namespace StrangeWeatherBus {
+
+static const uint32_t VERSION = 1;
+static const int BANKS = 4;
+static const int MAX_VOICES = 16;
+
+struct Bank {
+    int32_t type;         // AttractorType
+    int32_t channels;     // Voices in use; the per-voice arrays are only filled up to here
+    int32_t voltageMode;  // 0=±5V, 1=±10V, 2=0-5V, 3=0-10V
+    bool audioRate;
+    // Wasn't integrated for this sample and holds its last state: nothing uses the bank,
+    // including every consumer next to the module
+    bool suspended;
+    // Normalized state per voice and axis (x, y, z), -1 to 1: raw at the last control
+    // frame, and smoothed as interpolated for this sample before voltage scaling.
+    // Audio-rate banks aren't smoothed, so both hold the decimated output.
+    float raw[3][MAX_VOICES];
+    float smoothed[3][MAX_VOICES];
+    // Bounds each voice is normalized against, in attractor units
+    float min[3][MAX_VOICES];
+    float max[3][MAX_VOICES];
+};
+
+struct Message {
+    uint32_t version;     // VERSION; anything else means the layout differs
+    int64_t moduleId;     // Producing module
+    Bank banks[BANKS];
+    float combined[4];    // Combined outputs in volts: sum, rectified, inverted, inverse distance
+    // The producer's display trails, shared rather than copied. Read them through a
+    // TrailSnapshot (which retries torn copies), and only while the expander side still
+    // points at moduleId: the buffer goes away with the module.
+    const TrailBuffer* trails;
+};
+
+// Marks a module as a bus consumer, so Strange Weather only writes into expander
+// messages laid out as a Message
+struct Consumer {
+    virtual ~Consumer() {}
+
+    // Banks the consumer reads, bit 0 for bank A. Called from the producer's process()
+    // once per control frame; banks no one reads sleep like unpatched ones.
+    virtual uint32_t busBanks() {
+        return (1 << BANKS) - 1;
+    }
+};
+
+}  // namespace StrangeWeatherBus
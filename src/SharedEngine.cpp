@@ -0,0 +1,189 @@
+#include "SharedEngine.hpp"
+#include "AttractorLanes.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+
+namespace {
+
+typedef SharedEngine::Job Job;
+
+std::mutex registryMutex;  // Serializes add() and remove() only
+std::atomic<Job*> jobs[SharedEngine::MAX_JOBS];
+std::atomic<int> jobCount{0};  // Every registered job sits below this slot
+// Threads looking through the slots, which remove() waits out before a job goes away
+std::atomic<int> scanning{0};
+
+// A thread stops claiming once it holds this many attractors, so threads reaching their
+// frames at the same time split the work
+const int CLAIM_ATTRACTORS = 256;
+const int MAX_CLAIMED = CLAIM_ATTRACTORS + Job::SIZE;
+
+// Batches never mix lane settings or types: bit 4 precision, 3 fast sine, 2 bounds
+// tracking, then the AttractorType
+const int NUM_KEYS = 32;
+
+int keyOf(const Job& job, int index) {
+    return (job.floatEngine << 4) | (job.fastSine << 3) | (job.trackBounds << 2) | job.attractors[index]->type;
+}
+
+bool tryClaim(Job& job) {
+    int expected = SharedEngine::PENDING;
+    return job.state.compare_exchange_strong(expected, SharedEngine::RUNNING, std::memory_order_acquire);
+}
+
+// Claim `first` if it is still pending, then other pending jobs up to CLAIM_ATTRACTORS.
+// Returns the number claimed.
+int claim(Job* first, Job** claimed) {
+    int n = 0;
+    int total = 0;
+    scanning.fetch_add(1);
+    if (first && tryClaim(*first)) {
+        claimed[n++] = first;
+        total += first->count;
+    }
+    int end = jobCount.load();
+    for (int s = 0; s < end && total < CLAIM_ATTRACTORS; s++) {
+        Job* job = jobs[s].load();
+        if (!job || job == first || job->state.load(std::memory_order_relaxed) != SharedEngine::PENDING)
+            continue;
+        if (tryClaim(*job)) {
+            claimed[n++] = job;
+            total += job->count;
+        }
+    }
+    scanning.fetch_sub(1);
+    return n;
+}
+
+// Integrate every attractor of the claimed jobs, grouped by key four lanes at a time,
+// and mark the jobs DONE
+void run(Job** claimed, int n) {
+    struct Entry {
+        Job* job;
+        int index;
+    };
+    Entry entries[MAX_CLAIMED];
+    int start[NUM_KEYS + 1] = {};
+    bool timed = false;
+    for (int j = 0; j < n; j++) {
+        for (int k = 0; k < claimed[j]->count; k++) {
+            start[keyOf(*claimed[j], k) + 1]++;
+        }
+        timed = timed || claimed[j]->timed;
+    }
+    for (int key = 0; key < NUM_KEYS; key++) {
+        start[key + 1] += start[key];
+    }
+    int fill[NUM_KEYS];
+    std::copy(start, start + NUM_KEYS, fill);
+    for (int j = 0; j < n; j++) {
+        for (int k = 0; k < claimed[j]->count; k++) {
+            Entry& e = entries[fill[keyOf(*claimed[j], k)]++];
+            e.job = claimed[j];
+            e.index = k;
+        }
+    }
+
+    AttractorLanes lanes;
+    AttractorLanesFloat lanesFloat;
+    for (int key = 0; key < NUM_KEYS; key++) {
+        bool useFloat = key & 16;
+        bool trackBounds = key & 4;
+        lanes.fastSine = lanesFloat.fastSine = key & 8;
+        for (int b = start[key]; b < start[key + 1]; b += AttractorLanes::LANES) {
+            int count = std::min((int)AttractorLanes::LANES, start[key + 1] - b);
+            Attractor* group[AttractorLanes::LANES];
+            double dt[AttractorLanes::LANES];
+            int steps = 1;
+            for (int i = 0; i < count; i++) {
+                const Entry& e = entries[b + i];
+                group[i] = e.job->attractors[e.index];
+                dt[i] = e.job->dt[e.index];
+                steps = std::max(steps, e.job->steps[e.index]);
+            }
+            double begin = timed ? system::getTime() : 0.0;
+            if (useFloat)
+                lanesFloat.integrate(group, count, dt, steps, trackBounds);
+            else
+                lanes.integrate(group, count, dt, steps, trackBounds);
+            double share = timed ? (system::getTime() - begin) / count : 0.0;
+            for (int i = 0; i < count; i++) {
+                const Entry& e = entries[b + i];
+                e.job->taken[e.index] = steps;
+                e.job->seconds[e.index] = share;
+            }
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        claimed[j]->state.store(SharedEngine::DONE, std::memory_order_release);
+    }
+}
+
+}  // namespace
+
+
+bool SharedEngine::add(Job& job) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (int s = 0; s < MAX_JOBS; s++) {
+        if (jobs[s].load())
+            continue;
+        jobs[s].store(&job);
+        if (s >= jobCount.load()) {
+            jobCount.store(s + 1);
+        }
+        return true;
+    }
+    return false;
+}
+
+
+void SharedEngine::remove(Job& job) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    int end = jobCount.load();
+    for (int s = 0; s < end; s++) {
+        if (jobs[s].load() == &job) {
+            jobs[s].store(nullptr);
+        }
+    }
+    while (end > 0 && !jobs[end - 1].load()) {
+        end--;
+    }
+    jobCount.store(end);
+
+    // Once no thread is scanning, none can claim the job any more
+    while (scanning.load() > 0) {
+        std::this_thread::yield();
+    }
+    int expected = PENDING;
+    if (!job.state.compare_exchange_strong(expected, IDLE)) {
+        while (job.state.load(std::memory_order_acquire) == RUNNING) {
+            std::this_thread::yield();
+        }
+    }
+    job.state.store(IDLE, std::memory_order_relaxed);
+}
+
+
+void SharedEngine::finish(Job& job) {
+    Job* claimed[MAX_CLAIMED];
+    while (true) {
+        int state = job.state.load(std::memory_order_acquire);
+        if (state == IDLE)
+            return;
+        if (state == DONE)
+            break;
+        // Run our own job with whatever else is waiting, or help while another thread
+        // finishes it
+        int n = claim(state == PENDING ? &job : nullptr, claimed);
+        if (n > 0) {
+            run(claimed, n);
+        }
+        else if (state == RUNNING) {
+            std::this_thread::yield();
+        }
+    }
+    job.state.store(IDLE, std::memory_order_relaxed);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "Attractor.hpp"
+
+#include <atomic>
+
+
+// Plugin-wide scheduler for modules that opt into sharing their control-rate integration.
+// Each module owns a Job, registered here for its lifetime. At a control frame it hands
+// the frame's attractors over with submit() and goes on rendering the block; at its
+// next frame it calls finish(), which returns once the job has been integrated.
+//
+// Nothing runs in the background: whichever engine thread first needs a job that is
+// still PENDING claims it together with the other pending jobs, sorts all their
+// attractors by type and lane settings, and integrates them in full single-kernel SIMD
+// batches. With many instances that replaces each module's partly-filled mixed batches,
+// and Rack's engine threads share the work as they reach their own frames. A thread
+// whose job is RUNNING elsewhere helps with what is left, then yields until it is DONE.
+// Jobs are single-owner handoffs guarded by their atomic state, so nothing locks or
+// allocates on the audio thread.
+struct SharedEngine {
+    enum JobState {
+        IDLE,
+        PENDING,
+        RUNNING,
+        DONE
+    };
+
+    struct Job {
+        static const int SIZE = 128;
+        std::atomic<int> state{IDLE};
+        // Written by the owner before PENDING
+        int count = 0;
+        Attractor* attractors[SIZE];
+        double dt[SIZE];
+        int steps[SIZE];         // RK4 substeps wanted
+        bool floatEngine = false;
+        bool fastSine = false;
+        bool trackBounds = true;
+        bool timed = false;      // Measure the integration time
+        // Written by the thread that ran it before DONE
+        int taken[SIZE];         // Substeps actually integrated
+        double seconds[SIZE];    // Integration time, if timed
+    };
+
+    // Most modules that can share at once; later ones integrate on their own
+    static const int MAX_JOBS = 256;
+
+    // Call from the module constructor/destructor, never from the audio thread. add()
+    // returns false if every slot is taken. remove() waits for a job some other thread
+    // is running, and drops one that is only pending.
+    static bool add(Job& job);
+    static void remove(Job& job);
+
+    // Audio thread: publish a filled job, and wait until it has been integrated
+    static void submit(Job& job) {
+        job.state.store(PENDING, std::memory_order_release);
+    }
+    static void finish(Job& job);
+};
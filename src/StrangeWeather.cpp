@@ -14,242 +14,18 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-// Attractor types
-enum AttractorType {
-    SPROTT_B = 0,
-    ROSSLER = 1,
-    THOMAS = 2,
-    DADRAS = 3
-};
-
-// Attractor state and parameters
-struct Attractor {
-    double x, y, z;
-    AttractorType type;
-    float chaos = 0.5f; // 0-1, controls primary chaos parameter
-
-    // Bounding box tracking for normalization
-    double minX, maxX, minY, maxY, minZ, maxZ;
-
-        double boundLimit() const {
-            switch (type) {
-                case SPROTT_B: return 5.0;  // Sprott B is compact
-                case ROSSLER: return 35.0;
-                case THOMAS: return 8.0;
-                case DADRAS: return 15.0;  // Tighter bounds for stability
-            }
-        return 35.0;
-        }
-
-    void finalizeBounds() {
-        double lim = boundLimit();
-        auto clampTo = [lim](double& vmin, double& vmax) {
-            vmin = std::max(vmin, -lim);
-            vmax = std::min(vmax, lim);
-            if (vmax - vmin < 1e-3) {
-                vmin -= 1.0;
-                vmax += 1.0;
-            }
-        };
-        clampTo(minX, maxX);
-        clampTo(minY, maxY);
-        clampTo(minZ, maxZ);
-    }
-
-    Attractor() {
-        type = SPROTT_B;
-        resetState();
-    }
-
-    // Reset state to good initial conditions for current attractor type
-    void resetState() {
-        // Each attractor has different scale/basin - use appropriate initial conditions
-        int warmupSteps = 0;
-        double warmupDt = 0.0;
-        switch (type) {
-            case SPROTT_B:
-                // Sprott B - compact attractor, start near origin
-                x = 0.1 + (random::uniform() - 0.5) * 0.1;
-                y = 0.1 + (random::uniform() - 0.5) * 0.1;
-                z = 0.1 + (random::uniform() - 0.5) * 0.1;
-                minX = maxX = x;
-                minY = maxY = y;
-                minZ = maxZ = z;
-                warmupSteps = 2000; warmupDt = 0.01;
-                break;
-            case ROSSLER:
-                // Rossler orbits around origin; use a tiny asymmetry to avoid the trivial zero orbit
-                x = 0.1 + (random::uniform() - 0.5) * 0.02;
-                y = 0.1 + (random::uniform() - 0.5) * 0.02;
-                z = 0.0 + (random::uniform() - 0.5) * 0.02;
-                minX = maxX = x;
-                minY = maxY = y;
-                minZ = maxZ = z;
-                warmupSteps = 2000; warmupDt = 0.01;
-                break;
-            case THOMAS:
-                // Thomas is bounded roughly [-5, 5], needs asymmetric start to avoid fixed points
-                x = 1.0 + (random::uniform() - 0.5) * 0.5;
-                y = 1.1 + (random::uniform() - 0.5) * 0.5;
-                z = 1.2 + (random::uniform() - 0.5) * 0.5;
-                minX = maxX = x;
-                minY = maxY = y;
-                minZ = maxZ = z;
-                warmupSteps = 1500; warmupDt = 0.01;
-                break;
-            case DADRAS:
-                // Dadras: start near attractor basin
-                x = 1.0 + (random::uniform() - 0.5) * 0.2;
-                y = 1.0 + (random::uniform() - 0.5) * 0.2;
-                z = 1.0 + (random::uniform() - 0.5) * 0.2;
-                minX = maxX = x;
-                minY = maxY = y;
-                minZ = maxZ = z;
-                warmupSteps = 2000; warmupDt = 0.01;
-                break;
-        }
-        if (warmupSteps > 0 && warmupDt > 0.0) {
-            warmup(warmupSteps, warmupDt);
-            // Add a tiny perturbation and short settle to avoid periodic lock-in
-            x += (random::uniform() - 0.5) * 0.01;
-            y += (random::uniform() - 0.5) * 0.01;
-            z += (random::uniform() - 0.5) * 0.01;
-            warmup(500, warmupDt);
-            // Keep bounds from warmup but clamp to reasonable span
-            finalizeBounds();
-        }
-    }
-
-    // Set type and reset state if type changed
-    void setType(AttractorType newType) {
-        if (newType != type) {
-            type = newType;
-            resetState();
-        }
-    }
-
-    // Run a short, fixed warmup so the attractor settles into its orbit immediately
-    void warmup(int steps, double dt) {
-        for (int i = 0; i < steps; i++) {
-            step(dt);
-        }
-    }
-
-    // Compute derivatives for current state (chaos affects primary parameter)
-    void derivatives(double& dx, double& dy, double& dz) {
-        switch (type) {
-            case SPROTT_B: {
-                // Sprott B - minimal chaotic system, no tunable parameters
-                dx = y * z;
-                dy = x - y;
-                dz = 1.0 - x * y;
-                break;
-            }
-            case ROSSLER: {
-                // a = 0.2, b = 0.2, c varies in the classic chaotic window ~5.7-7.0
-                const double a = 0.2;
-                const double b = 0.2;
-                // Staying near the canonical c=5.7 avoids runaway excursions that draw as a box
-                const double c = 5.7 + chaos * 1.3;  // chaos: classic → slightly wilder but still bounded
-                dx = -y - z;
-                dy = x + a * y;
-                dz = b + z * (x - c);
-                break;
-            }
-            case THOMAS: {
-                // b must be < 0.208186 for chaos! Range: 0.19 down to 0.1
-                const double b = 0.19 - chaos * 0.09;  // chaos: mild → wild (always chaotic)
-                dx = std::sin(y) - b * x;
-                dy = std::sin(z) - b * y;
-                dz = std::sin(x) - b * z;
-                break;
-            }
-            case DADRAS: {
-                // Dadras attractor - multi-wing dynamics
-                const double a = 3.0;
-                const double b = 2.7;
-                const double c = 1.7 + chaos * 0.6;  // chaos varies c for different dynamics
-                const double d = 2.0;
-                const double e = 9.0;
-                dx = y - a * x + b * y * z;
-                dy = c * y - x * z + z;
-                dz = d * x * y - e * z;
-                break;
-            }
-        }
-    }
-    
-    // RK4 integration step
-    void step(double dt) {
-        // Blow-up guard: if state became non-finite or too large, re-seed
-        // Use tighter threshold (1000) to catch runaway before it causes issues
-        if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z) ||
-            std::abs(x) > 1000.0 || std::abs(y) > 1000.0 || std::abs(z) > 1000.0) {
-            resetState();
-            return;  // Skip this step after reset
-        }
-
-        double k1x, k1y, k1z;
-        double k2x, k2y, k2z;
-        double k3x, k3y, k3z;
-        double k4x, k4y, k4z;
-        
-        double ox = x, oy = y, oz = z;
-        
-        // k1
-        derivatives(k1x, k1y, k1z);
-        
-        // k2
-        x = ox + 0.5 * dt * k1x;
-        y = oy + 0.5 * dt * k1y;
-        z = oz + 0.5 * dt * k1z;
-        derivatives(k2x, k2y, k2z);
-        
-        // k3
-        x = ox + 0.5 * dt * k2x;
-        y = oy + 0.5 * dt * k2y;
-        z = oz + 0.5 * dt * k2z;
-        derivatives(k3x, k3y, k3z);
-        
-        // k4
-        x = ox + dt * k3x;
-        y = oy + dt * k3y;
-        z = oz + dt * k3z;
-        derivatives(k4x, k4y, k4z);
-        
-        // Final update
-        x = ox + (dt / 6.0) * (k1x + 2.0 * k2x + 2.0 * k3x + k4x);
-        y = oy + (dt / 6.0) * (k1y + 2.0 * k2y + 2.0 * k3y + k4y);
-        z = oz + (dt / 6.0) * (k1z + 2.0 * k2z + 2.0 * k3z + k4z);
-
-        // Update bounding box - expand only
-        minX = std::min(minX, x);
-        maxX = std::max(maxX, x);
-        minY = std::min(minY, y);
-        maxY = std::max(maxY, y);
-        minZ = std::min(minZ, z);
-        maxZ = std::max(maxZ, z);
-    }
-    
-    // Get normalized outputs (-5V to +5V)
-    float getNormX() {
-        double range = maxX - minX;
-        if (range < 0.001) range = 0.001;
-        return (float)(((x - minX) / range) * 10.0 - 5.0);
-    }
-    
-    float getNormY() {
-        double range = maxY - minY;
-        if (range < 0.001) range = 0.001;
-        return (float)(((y - minY) / range) * 10.0 - 5.0);
-    }
-    
-    float getNormZ() {
-        double range = maxZ - minZ;
-        if (range < 0.001) range = 0.001;
-        return (float)(((z - minZ) / range) * 10.0 - 5.0);
-    }
-};
+#include "Attractor.hpp"
+#include "AttractorLanes.hpp"
+#include "AttractorOrbitTable.hpp"
+#include "AttractorSeedCache.hpp"
+#include "AttractorSeeder.hpp"
+#include "BankStats.hpp"
+#include "BoundsWindow.hpp"
+#include "Decimator.hpp"
+#include "ExpanderBus.hpp"
+#include "SharedEngine.hpp"
+#include "TrailBuffer.hpp"
+#include "TrajectoryRecorder.hpp"
 
 
 struct StrangeWeather : Module {
@@ -280,6 +56,14 @@ struct StrangeWeather : Module {
     };
     
     enum InputIds {
+        RATE_A_INPUT,
+        RATE_B_INPUT,
+        RATE_C_INPUT,
+        RATE_D_INPUT,
+        CHAOS_A_INPUT,
+        CHAOS_B_INPUT,
+        CHAOS_C_INPUT,
+        CHAOS_D_INPUT,
         NUM_INPUTS
     };
     
@@ -316,17 +100,60 @@ struct StrangeWeather : Module {
         NUM_LIGHTS
     };
     
-    // Four attractor banks
-    Attractor attractors[4];
-
-    // Smoothed outputs (one-pole lowpass)
-    float smoothedX[4] = {0.f, 0.f, 0.f, 0.f};
-    float smoothedY[4] = {0.f, 0.f, 0.f, 0.f};
-    float smoothedZ[4] = {0.f, 0.f, 0.f, 0.f};
-    // Raw normalized (for display trails)
+    // Four attractor banks of up to 16 independently seeded voices (one per poly channel),
+    // all integrated together by a SIMD lane engine
+    static const int MAX_CHANNELS = 16;
+    Attractor attractors[4][MAX_CHANNELS];
+    AttractorLanes lanes;
+    AttractorLanesFloat lanesFloat;
+    int channels[4] = {1, 1, 1, 1};        // Polyphony setting per bank
+    int activeChannels[4] = {1, 1, 1, 1};  // Channel count latched for the current frame
+
+    // Background re-seeding: shape changes, resets and blow-ups request a warmup from the
+    // seeder thread and keep the old trajectory running until it arrives, then crossfade
+    static constexpr float RESEED_FADE_TIME = 0.5f;  // seconds
+    bool asyncReseed = true;
+    std::shared_ptr<AttractorSeeder::Slots> seedSlots;
+    bool forceReseed[4][MAX_CHANNELS] = {};   // Re-seed even though the shape is unchanged
+    Attractor fadeFrom[4][MAX_CHANNELS];      // Old trajectory, still running during the crossfade
+    float fadeAmount[4][MAX_CHANNELS] = {};   // 1 = all old trajectory, 0 = crossfade done
+
+    // Smoothed outputs (one-pole lowpass, updated once per control frame)
+    float smoothedX[4][MAX_CHANNELS] = {};
+    float smoothedY[4][MAX_CHANNELS] = {};
+    float smoothedZ[4][MAX_CHANNELS] = {};
+    // Previous control frame, interpolated towards smoothedX/Y/Z across the block
+    float prevSmoothedX[4][MAX_CHANNELS] = {};
+    float prevSmoothedY[4][MAX_CHANNELS] = {};
+    float prevSmoothedZ[4][MAX_CHANNELS] = {};
+    int voltageModes[4] = {0, 0, 0, 0};
+    // Banks whose outputs are unpatched and that aren't displayed or feeding the combined
+    // outputs are not integrated at all (see bankInUse)
+    bool bankSuspended[4] = {};
+    float suspendedTime[4] = {};  // Time a suspended bank has missed, before per-type scaling
+    static constexpr float MAX_CATCH_UP = 2000.f;  // Longest catch-up on resume (time units)
+    // Raw normalized of channel 0 (for display trails)
     float displayX[4] = {0.f, 0.f, 0.f, 0.f};
     float displayY[4] = {0.f, 0.f, 0.f, 0.f};
     float displayZ[4] = {0.f, 0.f, 0.f, 0.f};
+    // Raw normalized state of every voice at the last control frame (the decimated
+    // output for audio-rate banks), for the expander bus
+    float rawStateX[4][MAX_CHANNELS] = {};
+    float rawStateY[4][MAX_CHANNELS] = {};
+    float rawStateZ[4][MAX_CHANNELS] = {};
+    // Normalization bounds of control-rate voices at the same frame (min x, max x, min y,
+    // ...), as the shared engine may be integrating the voices themselves meanwhile
+    float rawBounds[4][MAX_CHANNELS][6] = {};
+    // Bus consumers next to the module (see ExpanderBus.hpp), checked on expander changes
+    StrangeWeatherBus::Consumer* busLeft = nullptr;
+    StrangeWeatherBus::Consumer* busRight = nullptr;
+
+    // Recording of the outputs to a file in the Rack user folder (see TrajectoryRecorder).
+    // Format and decimation are taken when a recording starts.
+    static const int NUM_RECORD_DECIMATIONS = 4;
+    TrajectoryRecorder recorder;
+    int recordFormat = TrajectoryRecorder::WAV;
+    int recordDecimation = 0;  // Index into recordDecimationFactor()
 
     // Display state
     int displayMode = 5; // 0=A, 1=B, 2=C, 3=D, 4=Combined, 5=All, 6=Ajman (if enabled)
@@ -334,45 +161,143 @@ struct StrangeWeather : Module {
     int displayStyle = 0; // 0=Trace, 1=Lissajous (tiny dots), 2=Scope
     bool ajmanEnabled = false; // Easter egg: enables Ajman mode in cycle
 
-    // Trail history for display (ring buffer)
-    static const int MAX_TRAIL_LENGTH = 4096;
-    float trailX[4][MAX_TRAIL_LENGTH] = {};
-    float trailY[4][MAX_TRAIL_LENGTH] = {};
-    float trailZ[4][MAX_TRAIL_LENGTH] = {};
-    int trailIndex = 0;
-
-    // Combined trail
-    float combTrailX[MAX_TRAIL_LENGTH] = {};
-    float combTrailY[MAX_TRAIL_LENGTH] = {};
-    float combTrailZ[MAX_TRAIL_LENGTH] = {};
+    // Trail history for display (ring buffer per bank plus the combined trail), read by
+    // AttractorDisplay through a TrailSnapshot
+    static const int MAX_TRAIL_LENGTH = TrailBuffer::LENGTH;
+    TrailBuffer trails;
 
     // Sample counter for trail updates
     int trailCounter = 0;
     int initDelay = 0;  // Delay before initializing trails (let smoothing settle)
 
+    // Control rate: attractors are integrated once per block of samples and the
+    // outputs are linearly interpolated between control frames
+    static const int NUM_CONTROL_RATES = 4;
+    int controlRate = 0;     // Index into controlBlockSizes() (0 = every sample)
+    int blockSize = 1;       // Block size latched at the start of the current frame
+    int controlPhase = 0;    // Samples elapsed in the current block
+    // Integrate with error-controlled Dormand-Prince steps instead of the fixed-step
+    // RK4 lane engine
+    bool adaptiveIntegrator = false;
+    // Run the RK4 lane engine in float, one SSE vector per four voices instead of two;
+    // double stays the reference. Attractor state is kept in double either way.
+    bool floatEngine = false;
+    // Thomas evaluates fastSin instead of std::sin, in the lane engine (either precision,
+    // audio rate included) and the adaptive integrator. Exact stays the default, so
+    // existing patches play back as before.
+    bool fastSine = false;
+    // Normalization: expand-only bounds tracked on every RK4 substep (the reference), or
+    // a sliding window over the last WINDOW_CYCLES main cycles (see audioPeriod) fed once
+    // per control frame, so one excursion doesn't shrink the output range for good.
+    // Audio-rate banks always track per substep, as a control-rate sample would miss
+    // their peaks.
+    static const int WINDOW_CYCLES = 8;
+    bool windowedBounds = false;
+    bool windowedBoundsActive = false;  // Setting the windows were last run with
+    BoundsWindow boundsWindows[4][MAX_CHANNELS];
+    // Hand control-rate RK4 integration to the SharedEngine, batched with every other
+    // instance that has this on. A frame's attractors are integrated while the block
+    // plays, so the outputs follow one control frame behind; at every-sample control rate
+    // and with the adaptive integrator the module integrates on its own as before.
+    bool sharedEngine = false;
+    bool sharedRegistered = false;  // Got a SharedEngine slot
+    bool sharedPending = false;     // sharedJob is submitted and not yet finished
+    bool sharedTimed = false;       // The submitted frame measures its integration time
+    // Table playback: at Low and Med range, voices read a shared precomputed orbit
+    // (CHAOS quantized to the seed cache buckets) instead of being integrated, once CHAOS
+    // has held still for ORBIT_HOLD_TIME; moving it hands back to live integration
+    static constexpr float ORBIT_HOLD_TIME = 0.25f;  // seconds
+    bool orbitTables = false;
+    float orbitChaos[4][MAX_CHANNELS];       // CHAOS value being held, per voice
+    float orbitHeld[4][MAX_CHANNELS] = {};   // Seconds it has held still
+
+    // Controls and CV of one bank as sampled at the last control frame. The per-voice
+    // values derived from them (rate, time step, substeps) are only recomputed when
+    // something they depend on changes, so a patched CV doesn't cost a pow per sample
+    // unless it actually moves.
+    static constexpr float CV_SCALE = 0.1f;  // Knob range per volt (±5V sweeps half of it)
+    struct BankControls {
+        int range = -1;
+        AttractorType type = SPROTT_B;
+        int voltage = 0;
+        int blockSize = 0;      // Control frame timing
+        float sampleRate = 0.f;
+        float rateAmount[MAX_CHANNELS];  // RATE knob plus CV, 0-1 (-1 = not computed yet)
+        float chaos[MAX_CHANNELS];       // CHAOS knob plus CV, 0-1
+        // Derived per voice
+        float blockTime[MAX_CHANNELS];   // Time covered per frame, before per-type scaling
+        double dt[MAX_CHANNELS];         // Same after the scaling for `type`
+        int steps[MAX_CHANNELS];         // RK4 substeps for dt
+        bool capped[MAX_CHANNELS];       // dt needed more than MAX_SUBSTEPS
+        // Audio-rate bank: dt, steps and capped are per oversampled point instead, and
+        // blockTime counts cycles
+        bool audio = false;
+        float pointTime[MAX_CHANNELS];   // Cycles per oversampled point
+    };
+    static const int MAX_SUBSTEPS = 100;
+    BankControls controls[4];
+    // Audio-rate banks run as chaotic oscillators: they are integrated every sample at
+    // Decimator4x::FACTOR times the sample rate, decimated, and output the raw normalized
+    // state with no smoothing. RATE sets the pitch and RATE CV tracks 1V/oct.
+    static constexpr float AUDIO_MIN_HZ = 20.f;
+    static constexpr float AUDIO_OCTAVES = 6.643856f;  // Knob range, 20 Hz to 2 kHz
+    static const int MAX_AUDIO_SUBSTEPS = 8;           // RK4 substeps per oversampled point
+    bool audioRate[4] = {};
+    Decimator4x audioDecimators[4][MAX_CHANNELS / 4][3];  // x, y, z per group of four voices
+    double audioSteps[4] = {};  // Substeps integrated since the last control frame
+
+    // One-pole smoothing coefficient per control frame, recomputed with the frame timing
+    float smoothCoeff = 0.f;
+    float smoothSampleRate = 0.f;
+    int smoothBlockSize = 0;
+
+    // Engine instrumentation, published every STATS_WINDOW seconds. Integration time is
+    // measured on one control frame in STATS_TIMING_INTERVAL; a batch's time is split
+    // evenly between its lanes.
+    static constexpr float STATS_WINDOW = 0.25f;
+    static const int STATS_TIMING_INTERVAL = 64;
+    BankStats bankStats[4];
+    std::atomic<uint32_t> statsGeneration{0};  // Bumped on every publish
+    int statsSamples = 0;   // Samples in the current window
+    int statsFrame = 0;     // Control frames since the last timed one
+    bool statsOverlay = false;  // Show the counters over the display
+
     dsp::SchmittTrigger resetTrigger;
 
+    // Re-seed one voice and restart its smoothing from zero
+    void resetVoice(int bank, int c) {
+        if (asyncReseed) {
+            forceReseed[bank][c] = true;
+        }
+        else {
+            attractors[bank][c].resetState();
+            fadeAmount[bank][c] = 0.f;
+        }
+        smoothedX[bank][c] = smoothedY[bank][c] = smoothedZ[bank][c] = 0.f;
+        prevSmoothedX[bank][c] = prevSmoothedY[bank][c] = prevSmoothedZ[bank][c] = 0.f;
+        boundsWindows[bank][c].type = -1;
+    }
+
     void performReset() {
+        finishShared();
         for (int i = 0; i < 4; i++) {
-            attractors[i].resetState();
-            smoothedX[i] = smoothedY[i] = smoothedZ[i] = 0.f;
-            for (int j = 0; j < MAX_TRAIL_LENGTH; j++) {
-                trailX[i][j] = 0.f;
-                trailY[i][j] = 0.f;
-                trailZ[i][j] = 0.f;
+            for (int c = 0; c < activeChannels[i]; c++) {
+                resetVoice(i, c);
             }
         }
-        for (int j = 0; j < MAX_TRAIL_LENGTH; j++) {
-            combTrailX[j] = combTrailY[j] = combTrailZ[j] = 0.f;
-        }
-        trailIndex = 0;
+        trails.clear();
         trailCounter = 0;
         initDelay = 0;
+        controlPhase = 0;
     }
     
     StrangeWeather() {
         config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
 
+        seedSlots = std::make_shared<AttractorSeeder::Slots>(4 * MAX_CHANNELS);
+        AttractorSeeder::add(seedSlots);
+        sharedRegistered = SharedEngine::add(sharedJob);
+
         // Rate knobs (fine control within selected range)
         configParam(RATE_A_PARAM, 0.f, 1.f, 0.5f, "Rate A");
         configParam(RATE_B_PARAM, 0.f, 1.f, 0.5f, "Rate B");
@@ -407,6 +332,16 @@ struct StrangeWeather : Module {
         configParam(TRAIL_PARAM, 0.f, 1.f, 0.7f, "Trail Length", "", 0.f, 1.f);
         configButton(RESET_PARAM, "Reset display and attractors");
 
+        // Rate and chaos CV, added to the knobs (polyphonic: one channel per voice)
+        configInput(RATE_A_INPUT, "Rate A CV");
+        configInput(RATE_B_INPUT, "Rate B CV");
+        configInput(RATE_C_INPUT, "Rate C CV");
+        configInput(RATE_D_INPUT, "Rate D CV");
+        configInput(CHAOS_A_INPUT, "Chaos A CV");
+        configInput(CHAOS_B_INPUT, "Chaos B CV");
+        configInput(CHAOS_C_INPUT, "Chaos C CV");
+        configInput(CHAOS_D_INPUT, "Chaos D CV");
+
         // Output labels
         configOutput(A_X_OUTPUT, "Bank A X");
         configOutput(A_Y_OUTPUT, "Bank A Y");
@@ -428,8 +363,37 @@ struct StrangeWeather : Module {
         configOutput(COMB_RECT_OUTPUT, "Combined Rectified");
         configOutput(COMB_INV_OUTPUT, "Combined Inverted");
         configOutput(COMB_DIST_OUTPUT, "Combined Inverse Distance");
+
+        // Shared by all instances; the first module constructed maps or regenerates it
+        AttractorSeedCache::load();
+
+        // Seed channel 1 of each bank with its default shape up front
+        for (int i = 0; i < 4; i++) {
+            for (int c = 0; c < MAX_CHANNELS; c++) {
+                orbitChaos[i][c] = -1.f;
+                controls[i].rateAmount[c] = -1.f;
+            }
+            attractors[i][0].type = (AttractorType)(3 - (int)params[SHAPE_A_PARAM + i].getValue());
+            attractors[i][0].resetState();
+        }
+    }
+
+    ~StrangeWeather() {
+        AttractorSeeder::remove(seedSlots);
+        if (sharedRegistered) {
+            SharedEngine::remove(sharedJob);
+        }
     }
     
+    // Called from the UI or patch loading: the first enable loads the shared tables,
+    // and voices integrate live until they are available
+    void setOrbitTables(bool enabled) {
+        if (enabled) {
+            AttractorOrbitTable::load();
+        }
+        orbitTables = enabled;
+    }
+
     void cycleDisplay() {
         int maxModes = ajmanEnabled ? 7 : 6;
         displayMode = (displayMode + 1) % maxModes;
@@ -439,11 +403,40 @@ struct StrangeWeather : Module {
         displayStyle = (displayStyle + 1) % 3;
     }
 
-    // Get current trail length from param (64 to 4096)
+    // Get current trail length from param (64 to 4096). Called from the UI thread on every
+    // draw, so the result is kept until the knob moves.
+    float trailKnob = -1.f;
+    int trailLength = 0;
     int getTrailLength() {
         float knob = params[TRAIL_PARAM].getValue();
-        // Exponential scaling: 64 at 0, 4096 at 1
-        return (int)(64.f * std::pow(64.f, knob));
+        if (knob != trailKnob) {
+            // Exponential scaling: 64 at 0, 4096 at 1
+            trailLength = (int)(64.f * std::pow(64.f, knob));
+            trailKnob = knob;
+        }
+        return trailLength;
+    }
+
+    // Samples per control frame for each control rate setting
+    static int controlBlockSize(int rate) {
+        static const int sizes[NUM_CONTROL_RATES] = {1, 16, 32, 64};
+        return sizes[clamp(rate, 0, NUM_CONTROL_RATES - 1)];
+    }
+
+    static int recordDecimationFactor(int index) {
+        static const int factors[NUM_RECORD_DECIMATIONS] = {1, 10, 100, 1000};
+        return factors[clamp(index, 0, NUM_RECORD_DECIMATIONS - 1)];
+    }
+
+    // Called from the UI
+    void toggleRecording() {
+        if (recorder.isRecording()) {
+            recorder.stop();
+        }
+        else {
+            recorder.start((TrajectoryRecorder::Format)recordFormat, recordDecimationFactor(recordDecimation),
+                           APP->engine->getSampleRate());
+        }
     }
 
     // Helper to calculate rate from range and knob
@@ -457,8 +450,9 @@ struct StrangeWeather : Module {
         return minHz * std::pow(maxHz / minHz, knob);
     }
 
-    // Helper to scale output based on voltage mode
-    float scaleVoltage(float normalized, int voltageMode) {
+    // Helper to scale output based on voltage mode (T = float or simd::float_4)
+    template <typename T>
+    static T scaleVoltage(T normalized, int voltageMode) {
         // normalized is -1 to +1
         switch (voltageMode) {
             case 0: return normalized * 5.0f;                    // ±5V
@@ -469,106 +463,622 @@ struct StrangeWeather : Module {
         }
     }
 
-    void process(const ProcessArgs& args) override {
+    // Type-specific rate scaling (Thomas is inherently slow, needs boost)
+    static float typeRateScale(AttractorType type) {
+        switch (type) {
+            case THOMAS: return 5.0f;    // Thomas is very slow
+            case ROSSLER: return 1.5f;   // Rossler is a bit slow
+            case SPROTT_B: return 1.0f;  // Sprott B runs at normal speed
+            case DADRAS: return 0.5f;    // Dadras needs slower integration for stability
+        }
+        return 1.0f;
+    }
+
+    // Time units per cycle of each shape's main oscillation (at CHAOS 50%), which sets the
+    // pitch of an audio-rate bank, and the largest RK4 step that keeps that waveform
+    // accurate, about 1/100 of a cycle. Dadras is stable only up to ~0.05.
+    static float audioPeriod(AttractorType type) {
+        switch (type) {
+            case SPROTT_B: return 13.5f;
+            case ROSSLER: return 5.9f;
+            case THOMAS: return 30.f;
+            case DADRAS: return 6.f;
+        }
+        return 10.f;
+    }
+
+    static float audioMaxStep(AttractorType type) {
+        switch (type) {
+            case SPROTT_B: return 0.1f;
+            case ROSSLER: return 0.05f;
+            case THOMAS: return 0.25f;
+            case DADRAS: return 0.025f;
+        }
+        return 0.025f;
+    }
+
+    // Hand a voice's shape changes, resets and blow-ups to the seeder thread, and swap in
+    // the seed once it is ready. Until then the old trajectory keeps running (or holds
+    // its last finite state after a blow-up).
+    void updateReseed(int bank, int c, AttractorType type, float chaos) {
+        Attractor& a = attractors[bank][c];
+        AttractorSeeder::Slot& slot = seedSlots->slots[bank * MAX_CHANNELS + c];
+        int state = slot.state.load(std::memory_order_acquire);
+        if (state == AttractorSeeder::READY) {
+            // Only take seeds for the shape the bank still wants
+            if (slot.staged.type == type) {
+                fadeFrom[bank][c] = a;
+                fadeAmount[bank][c] = 1.f;
+                a = slot.staged;
+            }
+            slot.state.store(AttractorSeeder::IDLE, std::memory_order_release);
+            state = AttractorSeeder::IDLE;
+        }
+        if (state == AttractorSeeder::IDLE && (a.type != type || a.needsReseed || forceReseed[bank][c])) {
+            AttractorSeeder::requestReseed(slot, type, chaos);
+            forceReseed[bank][c] = false;
+        }
+    }
+
+    // Whether anything consumes a bank: its own outputs, the combined outputs (which mix
+    // every bank), the display, a bus consumer reading it or a recording
+    bool bankInUse(int bank) {
+        for (int o = 0; o < 4; o++) {
+            if (outputs[A_X_OUTPUT + bank * 4 + o].isConnected())
+                return true;
+        }
+        for (int o = COMB_SUM_OUTPUT; o <= COMB_DIST_OUTPUT; o++) {
+            if (outputs[o].isConnected())
+                return true;
+        }
+        uint32_t busBanks = (busLeft ? busLeft->busBanks() : 0) | (busRight ? busRight->busBanks() : 0);
+        return displayMode == bank || displayMode == 4 || displayMode == 5 || (busBanks & (1 << bank)) ||
+               recorder.isRecording();
+    }
+
+    // Bring a suspended bank back. With background re-seeding, each voice keeps running
+    // from where it stopped while the seeder fast-forwards a copy by the time it missed,
+    // then crossfades to it. Voices whose shape changed, or that missed more than
+    // MAX_CATCH_UP (which no listener could tell from a fresh orbit), jump to a settled
+    // point from the seed cache (O(1)) and restart their smoothing there. Until the cache
+    // is ready that would be a full warmup, so with background re-seeding they keep
+    // running from where they stopped and crossfade to a seed from the seeder instead.
+    void resumeBank(int bank, float missed) {
+        AttractorType type = controls[bank].type;
+        double span = (double)missed * (controls[bank].audio ? audioPeriod(type) : typeRateScale(type));
+        for (int c = 0; c < activeChannels[bank]; c++) {
+            Attractor& a = attractors[bank][c];
+            a.chaos = controls[bank].chaos[c];
+            if (asyncReseed && a.type == type && !a.needsReseed && span > 0.0 && span <= MAX_CATCH_UP &&
+                AttractorSeeder::requestAdvance(seedSlots->slots[bank * MAX_CHANNELS + c], a, span)) {
+                continue;
+            }
+            if (asyncReseed && !AttractorSeedCache::ready()) {
+                // Requested by updateReseed later in this frame, as for resetVoice
+                forceReseed[bank][c] = true;
+                continue;
+            }
+            a.type = type;
+            a.resetState();
+            fadeAmount[bank][c] = 0.f;
+            forceReseed[bank][c] = false;
+            smoothedX[bank][c] = prevSmoothedX[bank][c] = clamp(a.getNormX() / 5.0f, -1.f, 1.f);
+            smoothedY[bank][c] = prevSmoothedY[bank][c] = clamp(a.getNormY() / 5.0f, -1.f, 1.f);
+            smoothedZ[bank][c] = prevSmoothedZ[bank][c] = clamp(a.getNormZ() / 5.0f, -1.f, 1.f);
+        }
+    }
+
+    // Every running attractor of a control frame (voices plus crossfade sources),
+    // flattened bank-major for batching
+    struct ActiveList {
+        static const int SIZE = 8 * MAX_CHANNELS;
+        Attractor* attractors[SIZE];
+        double dt[SIZE];
+        int steps[SIZE];      // RK4 substeps wanted
+        int bank[SIZE];
+        int taken[SIZE];      // Substeps actually integrated
+        double seconds[SIZE]; // Integration time, on timed frames
+        int count = 0;
+
+        // Queue an attractor for this block's integration
+        void add(Attractor& a, double dt, int steps, int b) {
+            attractors[count] = &a;
+            this->dt[count] = dt;
+            this->steps[count] = steps;
+            bank[count] = b;
+            count++;
+        }
+    };
+    SharedEngine::Job sharedJob;
+    ActiveList sharedActive;  // Banks of the submitted frame, then its substeps and timings
+
+    // Time step of one control frame for an attractor of `type`, and the RK4 substeps it
+    // takes (capped at MAX_SUBSTEPS); returns true if it needed more than the cap
+    static bool planSteps(float blockTime, AttractorType type, double& dt, int& steps) {
+        float scaled = blockTime * typeRateScale(type);
+        const float maxDt = AttractorLanes::MAX_STEP;
+        int wanted = (int)std::ceil(scaled / maxDt);
+        dt = scaled;
+        steps = std::max(1, std::min(wanted, (int)MAX_SUBSTEPS));
+        return wanted > MAX_SUBSTEPS;
+    }
+
+    // Time step of one oversampled point of an audio-rate voice of `type` running at
+    // `pointTime` cycles per point, and its substeps. At MAX_AUDIO_SUBSTEPS the step is
+    // held, so the pitch stops rising instead of the integration going unstable.
+    static bool planAudioSteps(float pointTime, AttractorType type, double& dt, int& steps) {
+        double maxDt = audioMaxStep(type);
+        dt = pointTime * audioPeriod(type);
+        int wanted = (int)std::ceil(dt / maxDt);
+        steps = clamp(wanted, 1, MAX_AUDIO_SUBSTEPS);
+        if (wanted > MAX_AUDIO_SUBSTEPS) {
+            dt = steps * maxDt;
+        }
+        return wanted > MAX_AUDIO_SUBSTEPS;
+    }
+
+    // Sample a bank's switches, knobs and CV for this control frame into controls[bank]
+    void updateControls(int bank, int numChannels, float sampleRate) {
+        BankControls& bc = controls[bank];
+        int range = (int)params[RANGE_A_PARAM + bank].getValue();
+        // Switch position is inverted from value (top=0, bottom=3 visually but value-wise top=3, bottom=0)
+        // Invert: 3-value so top position = Sprott B (0), bottom = Dadras (3)
+        AttractorType type = (AttractorType)(3 - (int)params[SHAPE_A_PARAM + bank].getValue());
+        bc.voltage = (int)params[VOLTAGE_A_PARAM + bank].getValue();
+        bool audio = audioRate[bank];
+        if (audio && !bc.audio) {
+            for (int g = 0; g < MAX_CHANNELS / 4; g++) {
+                for (int k = 0; k < 3; k++) {
+                    audioDecimators[bank][g][k].reset();
+                }
+            }
+        }
+        if (range != bc.range || type != bc.type || blockSize != bc.blockSize || sampleRate != bc.sampleRate ||
+            audio != bc.audio) {
+            bc.audio = audio;
+            bc.range = range;
+            bc.type = type;
+            bc.blockSize = blockSize;
+            bc.sampleRate = sampleRate;
+            for (int c = 0; c < MAX_CHANNELS; c++) {
+                bc.rateAmount[c] = -1.f;
+            }
+        }
+
+        float rateKnob = params[RATE_A_PARAM + bank].getValue();
+        float chaosKnob = params[CHAOS_A_PARAM + bank].getValue();
+        Input& rateIn = inputs[RATE_A_INPUT + bank];
+        Input& chaosIn = inputs[CHAOS_A_INPUT + bank];
+        bool rateCv = rateIn.isConnected();
+        bool chaosCv = chaosIn.isConnected();
+        for (int c = 0; c < numChannels; c++) {
+            float rate = rateKnob;
+            if (audio) {
+                // Octaves above AUDIO_MIN_HZ, 1.25 Hz to 5 kHz with CV
+                rate *= AUDIO_OCTAVES;
+                if (rateCv) {
+                    rate = clamp(rate + rateIn.getPolyVoltage(c), -4.f, 8.f);
+                }
+            }
+            else if (rateCv) {
+                rate = clamp(rate + rateIn.getPolyVoltage(c) * CV_SCALE, 0.f, 1.f);
+            }
+            if (rate != bc.rateAmount[c]) {
+                bc.rateAmount[c] = rate;
+                if (audio) {
+                    float hz = AUDIO_MIN_HZ * std::exp2(rate);
+                    bc.blockTime[c] = hz * blockSize / sampleRate;
+                    bc.pointTime[c] = hz / (sampleRate * Decimator4x::FACTOR);
+                    bc.capped[c] = planAudioSteps(bc.pointTime[c], type, bc.dt[c], bc.steps[c]);
+                }
+                else {
+                    bc.blockTime[c] = calculateRate(range, rate) * blockSize / sampleRate;
+                    bc.capped[c] = planSteps(bc.blockTime[c], type, bc.dt[c], bc.steps[c]);
+                }
+            }
+            float chaos = chaosKnob;
+            if (chaosCv) {
+                chaos = clamp(chaos + chaosIn.getPolyVoltage(c) * CV_SCALE, 0.f, 1.f);
+            }
+            bc.chaos[c] = chaos;
+        }
+    }
+
+    // Queue a voice or crossfade source for this frame's integration. Attractors still
+    // running an old shape (re-seed pending, or fading out) get their own time step.
+    void queueVoice(ActiveList& active, Attractor& a, int bank, int c) {
+        const BankControls& bc = controls[bank];
+        double dt = bc.dt[c];
+        int steps = bc.steps[c];
+        bool capped = bc.capped[c];
+        if (a.type != bc.type) {
+            capped = planSteps(bc.blockTime[c], a.type, dt, steps);
+        }
+        active.add(a, dt, steps, bank);
+        if (capped) {
+            bankStats[bank].capHitTotal++;
+        }
+    }
+
+    // Integrate every bank over one control block and compute the next control frame
+    void processControlFrame(const ProcessArgs& args) {
         // Smoothing coefficient (lower = smoother, ~0.001 at 48kHz gives nice smooth output)
-        float smoothCoeff = 6.0f / args.sampleRate;  // ~125ms time constant
+        if (args.sampleRate != smoothSampleRate || blockSize != smoothBlockSize) {
+            smoothSampleRate = args.sampleRate;
+            smoothBlockSize = blockSize;
+            smoothCoeff = 6.0f / args.sampleRate;  // ~125ms time constant
+            // Same time constant applied once per block instead of once per sample
+            if (blockSize > 1) {
+                smoothCoeff = 1.f - std::pow(1.f - smoothCoeff, (float)blockSize);
+            }
+        }
 
-        // Process each bank
-        int rangeParams[4] = {RANGE_A_PARAM, RANGE_B_PARAM, RANGE_C_PARAM, RANGE_D_PARAM};
-        int rateParams[4] = {RATE_A_PARAM, RATE_B_PARAM, RATE_C_PARAM, RATE_D_PARAM};
-        int shapeParams[4] = {SHAPE_A_PARAM, SHAPE_B_PARAM, SHAPE_C_PARAM, SHAPE_D_PARAM};
-        int voltageParams[4] = {VOLTAGE_A_PARAM, VOLTAGE_B_PARAM, VOLTAGE_C_PARAM, VOLTAGE_D_PARAM};
-        int chaosParams[4] = {CHAOS_A_PARAM, CHAOS_B_PARAM, CHAOS_C_PARAM, CHAOS_D_PARAM};
+        lanes.fastSine = lanesFloat.fastSine = fastSine;
 
-        float bankOutputs[4][4]; // [bank][x,y,z,sum]
+        // The previous frame's shared batch has to be in before anything touches a voice
+        finishShared();
+        bool shared = sharedEngine && sharedRegistered && blockSize > 1 && !adaptiveIntegrator;
 
-        // Handle reset button (momentary)
-        if (resetTrigger.process(params[RESET_PARAM].getValue())) {
-            performReset();
+        ActiveList active;
+        float frameTime = blockSize / args.sampleRate;
+        float fadeStep = blockSize / (RESEED_FADE_TIME * args.sampleRate);
+
+        for (int i = 0; i < 4; i++) {
+            int numChannels = clamp(channels[i], 1, MAX_CHANNELS);
+            updateControls(i, numChannels, args.sampleRate);
+            const BankControls& bc = controls[i];
+            AttractorType type = bc.type;
+            voltageModes[i] = bc.voltage;
+
+            if (!bankInUse(i)) {
+                if (!bankSuspended[i]) {
+                    bankSuspended[i] = true;
+                    suspendedTime[i] = 0.f;
+                }
+                suspendedTime[i] += bc.blockTime[0];
+                continue;
+            }
+            if (bankSuspended[i]) {
+                resumeBank(i, suspendedTime[i]);
+                bankSuspended[i] = false;
+            }
+
+            // Newly enabled voices start from a fresh, independently seeded orbit
+            for (int c = activeChannels[i]; c < numChannels; c++) {
+                // A background re-seed keeps the voice's previous state running meanwhile
+                if (!asyncReseed) {
+                    attractors[i][c].type = type;
+                }
+                resetVoice(i, c);
+            }
+            activeChannels[i] = numChannels;
+
+            bool useOrbits = orbitTables && bc.range < 2 && !bc.audio;
+            for (int c = 0; c < numChannels; c++) {
+                Attractor& a = attractors[i][c];
+                float chaos = bc.chaos[c];
+                if (asyncReseed) {
+                    updateReseed(i, c, type, chaos);
+                }
+                else {
+                    // Set attractor type (resets state if changed)
+                    a.setType(type);
+                    if (a.needsReseed) {
+                        a.resetState();
+                    }
+                }
+                a.chaos = chaos;
+                a.deferReseed = asyncReseed;
+
+                const AttractorOrbit* orbit = nullptr;
+                if (useOrbits) {
+                    if (std::fabs(chaos - orbitChaos[i][c]) > 1e-3f) {
+                        orbitChaos[i][c] = chaos;
+                        orbitHeld[i][c] = 0.f;
+                    }
+                    else {
+                        orbitHeld[i][c] += frameTime;
+                    }
+                    if (orbitHeld[i][c] >= ORBIT_HOLD_TIME) {
+                        orbit = AttractorOrbitTable::find(type, chaos);
+                    }
+                }
+
+                // Join the table orbit with a crossfade from the live trajectory, once any
+                // crossfade in progress is done
+                bool onOrbit = orbit && a.type == type && !a.needsReseed &&
+                               (a.orbit == orbit || fadeAmount[i][c] == 0.f);
+                if (bc.audio) {
+                    // Integrated every sample by renderAudioBank
+                    a.orbit = nullptr;
+                    if (bc.capped[c]) {
+                        bankStats[i].capHitTotal++;
+                    }
+                    bankStats[i].blowupTotal += a.blowups + fadeFrom[i][c].blowups;
+                    a.blowups = fadeFrom[i][c].blowups = 0;
+                }
+                else if (onOrbit) {
+                    if (a.orbit != orbit) {
+                        fadeFrom[i][c] = a;
+                        fadeFrom[i][c].orbit = nullptr;
+                        fadeAmount[i][c] = 1.f;
+                        a.startOrbit(orbit);
+                    }
+                    a.playOrbit(bc.dt[c]);
+                }
+                else {
+                    a.orbit = nullptr;
+                    // A voice waiting for a re-seed after a blow-up holds still
+                    if (!a.needsReseed) {
+                        queueVoice(active, a, i, c);
+                    }
+                }
+                if (fadeAmount[i][c] > 0.f) {
+                    fadeAmount[i][c] = std::max(fadeAmount[i][c] - fadeStep, 0.f);
+                    fadeFrom[i][c].chaos = chaos;
+                    if (!bc.audio && !fadeFrom[i][c].needsReseed) {
+                        queueVoice(active, fadeFrom[i][c], i, c);
+                    }
+                }
+            }
+        }
+
+        bool timed = ++statsFrame >= STATS_TIMING_INTERVAL;
+        if (timed) {
+            statsFrame = 0;
+        }
+        if (shared) {
+            // This frame goes to the engine once the outputs below have read it; the
+            // stats count the previous one, finished above
+            updateStats(sharedActive, sharedTimed, args.sampleRate);
+            sharedActive.count = 0;
+        }
+        else if (adaptiveIntegrator) {
+            // Each attractor covers its own span with as many steps as its dynamics need
+            for (int k = 0; k < active.count; k++) {
+                double start = timed ? system::getTime() : 0.0;
+                active.taken[k] = active.attractors[k]->advanceAdaptive(active.dt[k], fastSine);
+                if (timed) {
+                    active.seconds[k] = system::getTime() - start;
+                }
+            }
+        }
+        else {
+            // One RK4 pass per four voices; voices needing fewer substeps take finer ones
+            for (int b = 0; b < active.count; b += AttractorLanes::LANES) {
+                int count = std::min((int)AttractorLanes::LANES, active.count - b);
+                int steps = *std::max_element(active.steps + b, active.steps + b + count);
+                double start = timed ? system::getTime() : 0.0;
+                if (floatEngine)
+                    lanesFloat.integrate(active.attractors + b, count, active.dt + b, steps, !windowedBounds);
+                else
+                    lanes.integrate(active.attractors + b, count, active.dt + b, steps, !windowedBounds);
+                double share = timed ? (system::getTime() - start) / count : 0.0;
+                for (int k = b; k < b + count; k++) {
+                    active.taken[k] = steps;
+                    active.seconds[k] = share;
+                }
+            }
+        }
+        if (!shared) {
+            updateStats(active, timed, args.sampleRate);
+            sharedActive.count = 0;
+        }
+
+        if (windowedBounds || windowedBoundsActive) {
+            for (int i = 0; i < 4; i++) {
+                for (int c = 0; c < activeChannels[i]; c++) {
+                    // Windows restart from the current bounds whenever they weren't fed
+                    if (!windowedBounds || windowedBounds != windowedBoundsActive || bankSuspended[i] || controls[i].audio)
+                        boundsWindows[i][c].type = -1;
+                    else
+                        updateBoundsWindow(i, c);
+                }
+            }
+            windowedBoundsActive = windowedBounds;
         }
 
         for (int i = 0; i < 4; i++) {
-            // Get parameters
-            int range = (int)params[rangeParams[i]].getValue();
-            float rateKnob = params[rateParams[i]].getValue();
-            int voltageMode = (int)params[voltageParams[i]].getValue();
-
-            // Set attractor type (resets state if changed) and chaos
-            // Switch position is inverted from value (top=0, bottom=3 visually but value-wise top=3, bottom=0)
-            // Invert: 3-value so top position = Sprott B (0), bottom = Dadras (3)
-            int shapeValue = 3 - (int)params[shapeParams[i]].getValue();
-            attractors[i].setType((AttractorType)shapeValue);
-            attractors[i].chaos = params[chaosParams[i]].getValue();
-
-            // Calculate rate
-            float rate = calculateRate(range, rateKnob);
-
-            // Type-specific rate scaling (Thomas is inherently slow, needs boost)
-            float typeScale = 1.0f;
-            switch (attractors[i].type) {
-                case THOMAS: typeScale = 5.0f; break;   // Thomas is very slow
-                case ROSSLER: typeScale = 1.5f; break;  // Rossler is a bit slow
-                case SPROTT_B: typeScale = 1.0f; break;  // Sprott B runs at normal speed
-                case DADRAS: typeScale = 0.5f; break; // Dadras needs slower integration for stability
+            if (controls[i].audio)
+                continue;
+            for (int c = 0; c < activeChannels[i]; c++) {
+                Attractor& a = attractors[i][c];
+                // Get raw normalized outputs (-1 to +1)
+                // getNormX returns ±5V, convert to ±1 (clamp for safety, no gain boost)
+                float rawX = clamp(a.getNormX() / 5.0f, -1.f, 1.f);
+                float rawY = clamp(a.getNormY() / 5.0f, -1.f, 1.f);
+                float rawZ = clamp(a.getNormZ() / 5.0f, -1.f, 1.f);
+
+                // Crossfade from the old trajectory after a re-seed
+                float fade = fadeAmount[i][c];
+                if (fade > 0.f) {
+                    Attractor& old = fadeFrom[i][c];
+                    rawX += (clamp(old.getNormX() / 5.0f, -1.f, 1.f) - rawX) * fade;
+                    rawY += (clamp(old.getNormY() / 5.0f, -1.f, 1.f) - rawY) * fade;
+                    rawZ += (clamp(old.getNormZ() / 5.0f, -1.f, 1.f) - rawZ) * fade;
+                }
+
+                // Apply smoothing, keeping the previous frame as the interpolation start
+                prevSmoothedX[i][c] = smoothedX[i][c];
+                prevSmoothedY[i][c] = smoothedY[i][c];
+                prevSmoothedZ[i][c] = smoothedZ[i][c];
+                smoothedX[i][c] += smoothCoeff * (rawX - smoothedX[i][c]);
+                smoothedY[i][c] += smoothCoeff * (rawY - smoothedY[i][c]);
+                smoothedZ[i][c] += smoothCoeff * (rawZ - smoothedZ[i][c]);
+                rawStateX[i][c] = rawX;
+                rawStateY[i][c] = rawY;
+                rawStateZ[i][c] = rawZ;
+                const double bounds[6] = {a.minX, a.maxX, a.minY, a.maxY, a.minZ, a.maxZ};
+                std::copy(bounds, bounds + 6, rawBounds[i][c]);
             }
+        }
 
-            // Adaptive time step
-            float dt = rate * typeScale / args.sampleRate;
-            const float maxDt = 0.01f;
-            int steps = (int)std::ceil(dt / maxDt);
-            steps = std::max(1, std::min(steps, 100));
-            float subDt = dt / steps;
+        if (shared) {
+            submitShared(active, timed);
+        }
+    }
 
-            for (int s = 0; s < steps; s++) {
-                attractors[i].step(subDt);
+    // Wait for the frame handed to the shared engine (helping integrate it if nobody has
+    // yet) and collect its substeps and timings
+    void finishShared() {
+        if (!sharedPending)
+            return;
+        SharedEngine::finish(sharedJob);
+        std::copy(sharedJob.taken, sharedJob.taken + sharedActive.count, sharedActive.taken);
+        std::copy(sharedJob.seconds, sharedJob.seconds + sharedActive.count, sharedActive.seconds);
+        sharedPending = false;
+    }
+
+    // Queue this frame's attractors on the shared engine, to be integrated during the block
+    void submitShared(const ActiveList& active, bool timed) {
+        SharedEngine::Job& job = sharedJob;
+        sharedActive.count = active.count;
+        sharedTimed = timed;
+        job.count = active.count;
+        for (int k = 0; k < active.count; k++) {
+            sharedActive.attractors[k] = active.attractors[k];
+            sharedActive.bank[k] = active.bank[k];
+            job.attractors[k] = active.attractors[k];
+            job.dt[k] = active.dt[k];
+            job.steps[k] = active.steps[k];
+        }
+        job.floatEngine = floatEngine;
+        job.fastSine = fastSine;
+        job.trackBounds = !windowedBounds;
+        job.timed = timed;
+        if (active.count > 0) {
+            SharedEngine::submit(job);
+            sharedPending = true;
+        }
+    }
+
+    // Feed a voice's state at this control frame to its bounds window and normalize by the
+    // window: wider at once, narrower gliding over about one block, so an old block
+    // dropping out doesn't step the level
+    void updateBoundsWindow(int bank, int c) {
+        Attractor& a = attractors[bank][c];
+        BoundsWindow& w = boundsWindows[bank][c];
+        if (w.type != a.type) {
+            w.reset(a);
+        }
+        double time = controls[bank].blockTime[c] * typeRateScale(a.type);
+        double blockTime = (double)WINDOW_CYCLES * audioPeriod(a.type) / BoundsWindow::BLOCKS;
+        w.push(a.x, a.y, a.z, time, blockTime);
+        double glide = std::min(time / blockTime, 1.0);
+        double* lo[3] = {&a.minX, &a.minY, &a.minZ};
+        double* hi[3] = {&a.maxX, &a.maxY, &a.maxZ};
+        for (int k = 0; k < 3; k++) {
+            double low = w.low(k);
+            double high = w.high(k);
+            *lo[k] = (low < *lo[k]) ? low : *lo[k] + (low - *lo[k]) * glide;
+            *hi[k] = (high > *hi[k]) ? high : *hi[k] + (high - *hi[k]) * glide;
+        }
+        a.finalizeBounds();
+    }
+
+    // Fold a control frame into the bank counters and publish them once per window
+    void updateStats(ActiveList& active, bool timed, float sampleRate) {
+        double frameSteps[4] = {audioSteps[0], audioSteps[1], audioSteps[2], audioSteps[3]};
+        for (int i = 0; i < 4; i++) {
+            audioSteps[i] = 0.0;
+        }
+        for (int k = 0; k < active.count; k++) {
+            BankStats& stats = bankStats[active.bank[k]];
+            Attractor* a = active.attractors[k];
+            frameSteps[active.bank[k]] += active.taken[k];
+            stats.blowupTotal += a->blowups;
+            a->blowups = 0;
+            if (timed) {
+                stats.timedNs += active.seconds[k] * 1e9;
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            bankStats[i].addFrame(frameSteps[i], blockSize);
+            if (timed) {
+                bankStats[i].timedSamples += blockSize;
             }
+        }
+
+        statsSamples += blockSize;
+        if (statsSamples >= STATS_WINDOW * sampleRate) {
+            for (int i = 0; i < 4; i++) {
+                const Attractor& a = attractors[i][0];
+                bankStats[i].publish(statsSamples, a.maxX - a.minX, a.maxY - a.minY, a.maxZ - a.minZ);
+            }
+            statsSamples = 0;
+            statsGeneration.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void process(const ProcessArgs& args) override {
+        float bankOutputs[4][4] = {}; // [bank][x,y,z,sum]
+
+        // Handle reset button (momentary)
+        if (resetTrigger.process(params[RESET_PARAM].getValue())) {
+            performReset();
+        }
 
-            // Get raw normalized outputs (-1 to +1)
-            // getNormX returns ±5V, convert to ±1 (clamp for safety, no gain boost)
-            float rawX = clamp(attractors[i].getNormX() / 5.0f, -1.f, 1.f);
-            float rawY = clamp(attractors[i].getNormY() / 5.0f, -1.f, 1.f);
-            float rawZ = clamp(attractors[i].getNormZ() / 5.0f, -1.f, 1.f);
-
-            // Apply smoothing
-            smoothedX[i] += smoothCoeff * (rawX - smoothedX[i]);
-            smoothedY[i] += smoothCoeff * (rawY - smoothedY[i]);
-            smoothedZ[i] += smoothCoeff * (rawZ - smoothedZ[i]);
-
-            // Use smoothed values for display trails to reduce jitter
-            displayX[i] = clamp(smoothedX[i], -1.f, 1.f);
-            displayY[i] = clamp(smoothedY[i], -1.f, 1.f);
-            displayZ[i] = clamp(smoothedZ[i], -1.f, 1.f);
-
-            // Scale to voltage
-            bankOutputs[i][0] = scaleVoltage(smoothedX[i], voltageMode);
-            bankOutputs[i][1] = scaleVoltage(smoothedY[i], voltageMode);
-            bankOutputs[i][2] = scaleVoltage(smoothedZ[i], voltageMode);
-            bankOutputs[i][3] = bankOutputs[i][0] + bankOutputs[i][1] + bankOutputs[i][2];
-        }
-
-        // Bank A outputs
-        outputs[A_X_OUTPUT].setVoltage(bankOutputs[0][0]);
-        outputs[A_Y_OUTPUT].setVoltage(bankOutputs[0][1]);
-        outputs[A_Z_OUTPUT].setVoltage(bankOutputs[0][2]);
-        outputs[A_SUM_OUTPUT].setVoltage(bankOutputs[0][3]);
-
-        // Bank B outputs
-        outputs[B_X_OUTPUT].setVoltage(bankOutputs[1][0]);
-        outputs[B_Y_OUTPUT].setVoltage(bankOutputs[1][1]);
-        outputs[B_Z_OUTPUT].setVoltage(bankOutputs[1][2]);
-        outputs[B_SUM_OUTPUT].setVoltage(bankOutputs[1][3]);
-
-        // Bank C outputs
-        outputs[C_X_OUTPUT].setVoltage(bankOutputs[2][0]);
-        outputs[C_Y_OUTPUT].setVoltage(bankOutputs[2][1]);
-        outputs[C_Z_OUTPUT].setVoltage(bankOutputs[2][2]);
-        outputs[C_SUM_OUTPUT].setVoltage(bankOutputs[2][3]);
-
-        // Bank D outputs
-        outputs[D_X_OUTPUT].setVoltage(bankOutputs[3][0]);
-        outputs[D_Y_OUTPUT].setVoltage(bankOutputs[3][1]);
-        outputs[D_Z_OUTPUT].setVoltage(bankOutputs[3][2]);
-        outputs[D_SUM_OUTPUT].setVoltage(bankOutputs[3][3]);
+        // Start of a control block: read params and integrate the whole block at once
+        if (controlPhase == 0) {
+            blockSize = controlBlockSize(controlRate);
+            processControlFrame(args);
+        }
+        controlPhase++;
+        float frac = (float)controlPhase / blockSize;
+        if (controlPhase >= blockSize) {
+            controlPhase = 0;
+        }
+
+        for (int i = 0; i < 4; i++) {
+            if (bankSuspended[i])
+                continue;
+            if (controls[i].audio) {
+                renderAudioBank(i, bankOutputs[i]);
+                continue;
+            }
+            int numChannels = activeChannels[i];
+            // Output IDs are laid out as X, Y, Z, SUM per bank
+            Output& outX = outputs[A_X_OUTPUT + i * 4];
+            Output& outY = outputs[A_Y_OUTPUT + i * 4];
+            Output& outZ = outputs[A_Z_OUTPUT + i * 4];
+            Output& outSum = outputs[A_SUM_OUTPUT + i * 4];
+
+            for (int c = 0; c < numChannels; c += 4) {
+                // Interpolate between control frames (exactly the current frame when blockSize == 1)
+                simd::float_4 prevX = simd::float_4::load(&prevSmoothedX[i][c]);
+                simd::float_4 prevY = simd::float_4::load(&prevSmoothedY[i][c]);
+                simd::float_4 prevZ = simd::float_4::load(&prevSmoothedZ[i][c]);
+                simd::float_4 x = prevX + (simd::float_4::load(&smoothedX[i][c]) - prevX) * frac;
+                simd::float_4 y = prevY + (simd::float_4::load(&smoothedY[i][c]) - prevY) * frac;
+                simd::float_4 z = prevZ + (simd::float_4::load(&smoothedZ[i][c]) - prevZ) * frac;
+
+                // Scale to voltage
+                simd::float_4 vx = scaleVoltage(x, voltageModes[i]);
+                simd::float_4 vy = scaleVoltage(y, voltageModes[i]);
+                simd::float_4 vz = scaleVoltage(z, voltageModes[i]);
+                simd::float_4 vSum = vx + vy + vz;
+                outX.setVoltageSimd(vx, c);
+                outY.setVoltageSimd(vy, c);
+                outZ.setVoltageSimd(vz, c);
+                outSum.setVoltageSimd(vSum, c);
+
+                if (c == 0) {
+                    // Channel 0 drives the display trails and the combined outputs
+                    // Use smoothed values for display trails to reduce jitter
+                    displayX[i] = clamp(x[0], -1.f, 1.f);
+                    displayY[i] = clamp(y[0], -1.f, 1.f);
+                    displayZ[i] = clamp(z[0], -1.f, 1.f);
+                    bankOutputs[i][0] = vx[0];
+                    bankOutputs[i][1] = vy[0];
+                    bankOutputs[i][2] = vz[0];
+                    bankOutputs[i][3] = vSum[0];
+                }
+            }
+            outX.setChannels(numChannels);
+            outY.setChannels(numChannels);
+            outZ.setChannels(numChannels);
+            outSum.setChannels(numChannels);
+        }
 
         // Combined outputs (using smoothed normalized values for consistency)
         float combSum = bankOutputs[0][3] + bankOutputs[1][3] + bankOutputs[2][3] + bankOutputs[3][3];
@@ -581,59 +1091,255 @@ struct StrangeWeather : Module {
         outputs[COMB_INV_OUTPUT].setVoltage(combInv);
         outputs[COMB_DIST_OUTPUT].setVoltage(combDist);
 
+        if (busLeft || busRight) {
+            const float combined[4] = {combSum, combRect, combInv, combDist};
+            publishBus(frac, combined);
+        }
+        if (recorder.isRecording()) {
+            float frame[TrajectoryRecorder::CHANNELS];
+            std::copy(&bankOutputs[0][0], &bankOutputs[0][0] + 16, frame);
+            frame[16] = combSum;
+            frame[17] = combRect;
+            frame[18] = combInv;
+            frame[19] = combDist;
+            recorder.process(frame);
+        }
+
         // Update trail history (downsample for display)
         // Use fixed 30fps - good balance for all ranges
         trailCounter++;
         if (trailCounter >= (int)(args.sampleRate / 30.f)) {
             trailCounter = 0;
+            writeTrailSample();
+        }
+    }
+
+    // Integrate voices c0 to c0 + n - 1 of an audio-rate bank (or their crossfade sources)
+    // over the oversampled points of one sample, as [point][x, y, z] with a lane per voice.
+    // Voices waiting for a re-seed hold their last value.
+    void renderVoices(int bank, int c0, int n, bool old, simd::float_4 points[][3]) {
+        const int N = Decimator4x::FACTOR;
+        const BankControls& bc = controls[bank];
+        Attractor* live[4];
+        double dt[4];
+        int lane[4];
+        int count = 0;
+        int steps = 1;
+        for (int p = 0; p < N; p++) {
+            points[p][0] = points[p][1] = points[p][2] = 0.f;
+        }
+        for (int k = 0; k < n; k++) {
+            int c = c0 + k;
+            Attractor& a = old ? fadeFrom[bank][c] : attractors[bank][c];
+            if (old && fadeAmount[bank][c] == 0.f)
+                continue;
+            if (a.needsReseed) {
+                for (int p = 0; p < N; p++) {
+                    points[p][0][k] = clamp(a.getNormX() / 5.0f, -1.f, 1.f);
+                    points[p][1][k] = clamp(a.getNormY() / 5.0f, -1.f, 1.f);
+                    points[p][2][k] = clamp(a.getNormZ() / 5.0f, -1.f, 1.f);
+                }
+                continue;
+            }
+            int voiceSteps = bc.steps[c];
+            dt[count] = bc.dt[c];
+            if (a.type != bc.type) {
+                planAudioSteps(bc.pointTime[c], a.type, dt[count], voiceSteps);
+            }
+            steps = std::max(steps, voiceSteps);
+            live[count] = &a;
+            lane[count] = k;
+            count++;
+        }
+        if (count == 0)
+            return;
+
+        float rendered[N][3][AttractorLanes::LANES];
+        if (floatEngine)
+            lanesFloat.render(live, count, dt, steps, N, &rendered[0][0][0]);
+        else
+            lanes.render(live, count, dt, steps, N, &rendered[0][0][0]);
+        audioSteps[bank] += (double)steps * N * count;
+        for (int p = 0; p < N; p++) {
+            for (int j = 0; j < count; j++) {
+                points[p][0][lane[j]] = rendered[p][0][j];
+                points[p][1][lane[j]] = rendered[p][1][j];
+                points[p][2][lane[j]] = rendered[p][2][j];
+            }
+        }
+    }
 
-            // Wait for smoothing to settle, then fill trail with current position (clear screen)
-            initDelay++;
-            if (initDelay == 15) {  // 0.5s at 30fps
-                for (int j = 0; j < MAX_TRAIL_LENGTH; j++) {
-                    for (int i = 0; i < 4; i++) {
-                        trailX[i][j] = displayX[i];
-                        trailY[i][j] = displayY[i];
-                        trailZ[i][j] = displayZ[i];
+    // One sample of an audio-rate bank: integrate, crossfade, decimate and output
+    void renderAudioBank(int bank, float* bankOutput) {
+        const int N = Decimator4x::FACTOR;
+        int numChannels = activeChannels[bank];
+        Output& outX = outputs[A_X_OUTPUT + bank * 4];
+        Output& outY = outputs[A_Y_OUTPUT + bank * 4];
+        Output& outZ = outputs[A_Z_OUTPUT + bank * 4];
+        Output& outSum = outputs[A_SUM_OUTPUT + bank * 4];
+
+        for (int c = 0; c < numChannels; c += 4) {
+            int n = std::min(4, numChannels - c);
+            simd::float_4 points[N][3];
+            renderVoices(bank, c, n, false, points);
+
+            // Crossfade from the old trajectories after a re-seed
+            simd::float_4 fade = simd::float_4::load(&fadeAmount[bank][c]);
+            if (simd::movemask(fade > 0.f)) {
+                simd::float_4 old[N][3];
+                renderVoices(bank, c, n, true, old);
+                for (int p = 0; p < N; p++) {
+                    for (int k = 0; k < 3; k++) {
+                        points[p][k] += (old[p][k] - points[p][k]) * fade;
                     }
-                    // Combined - scale by 4 instead of 12 for more dynamic range
-                    float normSum = (displayX[0] + displayY[0] + displayZ[0] +
-                                    displayX[1] + displayY[1] + displayZ[1] +
-                                    displayX[2] + displayY[2] + displayZ[2] +
-                                    displayX[3] + displayY[3] + displayZ[3]) / 4.f;
-                    float normRect = (std::abs(displayX[0]) + std::abs(displayY[0]) + std::abs(displayZ[0]) +
-                                     std::abs(displayX[1]) + std::abs(displayY[1]) + std::abs(displayZ[1]) +
-                                     std::abs(displayX[2]) + std::abs(displayY[2]) + std::abs(displayZ[2]) +
-                                     std::abs(displayX[3]) + std::abs(displayY[3]) + std::abs(displayZ[3])) / 4.f;
-                    combTrailX[j] = clamp(normSum, -1.f, 1.f);
-                    combTrailY[j] = clamp(normRect - 1.f, -1.f, 1.f);
-                    combTrailZ[j] = clamp((displayZ[0] + displayZ[1] + displayZ[2] + displayZ[3]) / 2.f, -1.f, 1.f);
                 }
             }
 
-            trailIndex = (trailIndex + 1) % MAX_TRAIL_LENGTH;
+            simd::float_4 decimated[3];
+            for (int k = 0; k < 3; k++) {
+                simd::float_4 in[N];
+                for (int p = 0; p < N; p++) {
+                    in[p] = points[p][k];
+                }
+                decimated[k] = audioDecimators[bank][c / 4][k].process(in);
+            }
 
-            // Store smoothed normalized positions for display (-1 to 1 range, clamped)
-            for (int i = 0; i < 4; i++) {
-                trailX[i][trailIndex] = displayX[i];
-                trailY[i][trailIndex] = displayY[i];
-                trailZ[i][trailIndex] = displayZ[i];
+            decimated[0].store(&rawStateX[bank][c]);
+            decimated[1].store(&rawStateY[bank][c]);
+            decimated[2].store(&rawStateZ[bank][c]);
+
+            simd::float_4 vx = scaleVoltage(decimated[0], voltageModes[bank]);
+            simd::float_4 vy = scaleVoltage(decimated[1], voltageModes[bank]);
+            simd::float_4 vz = scaleVoltage(decimated[2], voltageModes[bank]);
+            simd::float_4 vSum = vx + vy + vz;
+            outX.setVoltageSimd(vx, c);
+            outY.setVoltageSimd(vy, c);
+            outZ.setVoltageSimd(vz, c);
+            outSum.setVoltageSimd(vSum, c);
+
+            if (c == 0) {
+                displayX[bank] = clamp(decimated[0][0], -1.f, 1.f);
+                displayY[bank] = clamp(decimated[1][0], -1.f, 1.f);
+                displayZ[bank] = clamp(decimated[2][0], -1.f, 1.f);
+                bankOutput[0] = vx[0];
+                bankOutput[1] = vy[0];
+                bankOutput[2] = vz[0];
+                bankOutput[3] = vSum[0];
+            }
+        }
+        outX.setChannels(numChannels);
+        outY.setChannels(numChannels);
+        outZ.setChannels(numChannels);
+        outSum.setChannels(numChannels);
+    }
+
+    void onSampleRateChange(const SampleRateChangeEvent& e) override {
+        recorder.setSampleRate(e.sampleRate);
+    }
+
+    void onExpanderChange(const ExpanderChangeEvent& e) override {
+        busLeft = dynamic_cast<StrangeWeatherBus::Consumer*>(leftExpander.module);
+        busRight = dynamic_cast<StrangeWeatherBus::Consumer*>(rightExpander.module);
+    }
+
+    // Fill the bus message of each consumer next to the module and flip it at the end of
+    // this engine step. `frac` is the interpolation position within the control block.
+    void publishBus(float frac, const float* combined) {
+        Module::Expander* sides[2] = {
+            (busRight && rightExpander.module) ? &rightExpander.module->leftExpander : nullptr,
+            (busLeft && leftExpander.module) ? &leftExpander.module->rightExpander : nullptr,
+        };
+        StrangeWeatherBus::Message* first = nullptr;
+        for (Module::Expander* side : sides) {
+            if (!side || !side->producerMessage)
+                continue;
+            StrangeWeatherBus::Message* msg = (StrangeWeatherBus::Message*)side->producerMessage;
+            if (first) {
+                *msg = *first;
+            }
+            else {
+                fillBusMessage(*msg, frac, combined);
+                first = msg;
+            }
+            side->requestMessageFlip();
+        }
+    }
+
+    void fillBusMessage(StrangeWeatherBus::Message& msg, float frac, const float* combined) {
+        msg.version = StrangeWeatherBus::VERSION;
+        msg.moduleId = id;
+        for (int i = 0; i < 4; i++) {
+            StrangeWeatherBus::Bank& bank = msg.banks[i];
+            bool audio = controls[i].audio;
+            bank.type = controls[i].type;
+            bank.channels = activeChannels[i];
+            bank.voltageMode = voltageModes[i];
+            bank.audioRate = audio;
+            bank.suspended = bankSuspended[i];
+            for (int c = 0; c < activeChannels[i]; c++) {
+                bank.raw[0][c] = rawStateX[i][c];
+                bank.raw[1][c] = rawStateY[i][c];
+                bank.raw[2][c] = rawStateZ[i][c];
+                if (audio) {
+                    bank.smoothed[0][c] = rawStateX[i][c];
+                    bank.smoothed[1][c] = rawStateY[i][c];
+                    bank.smoothed[2][c] = rawStateZ[i][c];
+                }
+                else {
+                    bank.smoothed[0][c] = prevSmoothedX[i][c] + (smoothedX[i][c] - prevSmoothedX[i][c]) * frac;
+                    bank.smoothed[1][c] = prevSmoothedY[i][c] + (smoothedY[i][c] - prevSmoothedY[i][c]) * frac;
+                    bank.smoothed[2][c] = prevSmoothedZ[i][c] + (smoothedZ[i][c] - prevSmoothedZ[i][c]) * frac;
+                }
+                if (audio) {
+                    const Attractor& a = attractors[i][c];
+                    bank.min[0][c] = (float)a.minX; bank.max[0][c] = (float)a.maxX;
+                    bank.min[1][c] = (float)a.minY; bank.max[1][c] = (float)a.maxY;
+                    bank.min[2][c] = (float)a.minZ; bank.max[2][c] = (float)a.maxZ;
+                }
+                else {
+                    for (int k = 0; k < 3; k++) {
+                        bank.min[k][c] = rawBounds[i][c][2 * k];
+                        bank.max[k][c] = rawBounds[i][c][2 * k + 1];
+                    }
+                }
             }
+        }
+        std::copy(combined, combined + 4, msg.combined);
+        msg.trails = &trails;
+    }
+
+    // Append the current display positions of every bank to the trail history
+    void writeTrailSample() {
+        trails.beginWrite();
+
+        // Wait for smoothing to settle, then restart the trail from the current position (clear screen)
+        initDelay++;
+        if (initDelay == 15) {  // 0.5s at 30fps
+            trails.valid = 0;
+        }
+
+        int trailIndex = trails.advance();
 
-            // Combined: use sum and rectified sum as x,y,z
-            // Scale by 4 instead of 12 for more dynamic range in display
-            float normSum = (displayX[0] + displayY[0] + displayZ[0] +
-                            displayX[1] + displayY[1] + displayZ[1] +
-                            displayX[2] + displayY[2] + displayZ[2] +
-                            displayX[3] + displayY[3] + displayZ[3]) / 4.f;
-            float normRect = (std::abs(displayX[0]) + std::abs(displayY[0]) + std::abs(displayZ[0]) +
-                             std::abs(displayX[1]) + std::abs(displayY[1]) + std::abs(displayZ[1]) +
-                             std::abs(displayX[2]) + std::abs(displayY[2]) + std::abs(displayZ[2]) +
-                             std::abs(displayX[3]) + std::abs(displayY[3]) + std::abs(displayZ[3])) / 4.f;
-            combTrailX[trailIndex] = clamp(normSum, -1.f, 1.f);
-            combTrailY[trailIndex] = clamp(normRect - 1.f, -1.f, 1.f);
-            combTrailZ[trailIndex] = clamp((displayZ[0] + displayZ[1] + displayZ[2] + displayZ[3]) / 2.f, -1.f, 1.f);
+        // Store smoothed normalized positions for display (-1 to 1 range, clamped)
+        for (int i = 0; i < 4; i++) {
+            trails.points[i][trailIndex].set(displayX[i], displayY[i], displayZ[i]);
         }
+
+        // Combined: use sum and rectified sum as x,y,z
+        // Scale by 4 instead of 12 for more dynamic range in display
+        float normSum = (displayX[0] + displayY[0] + displayZ[0] +
+                        displayX[1] + displayY[1] + displayZ[1] +
+                        displayX[2] + displayY[2] + displayZ[2] +
+                        displayX[3] + displayY[3] + displayZ[3]) / 4.f;
+        float normRect = (std::abs(displayX[0]) + std::abs(displayY[0]) + std::abs(displayZ[0]) +
+                         std::abs(displayX[1]) + std::abs(displayY[1]) + std::abs(displayZ[1]) +
+                         std::abs(displayX[2]) + std::abs(displayY[2]) + std::abs(displayZ[2]) +
+                         std::abs(displayX[3]) + std::abs(displayY[3]) + std::abs(displayZ[3])) / 4.f;
+        trails.points[TrailBuffer::COMBINED][trailIndex].set(
+            clamp(normSum, -1.f, 1.f),
+            clamp(normRect - 1.f, -1.f, 1.f),
+            clamp((displayZ[0] + displayZ[1] + displayZ[2] + displayZ[3]) / 2.f, -1.f, 1.f));
+        trails.endWrite();
     }
 
     json_t* dataToJson() override {
@@ -641,10 +1347,119 @@ struct StrangeWeather : Module {
         json_object_set_new(rootJ, "displayMode", json_integer(displayMode));
         json_object_set_new(rootJ, "display3D", json_boolean(display3D));
         json_object_set_new(rootJ, "displayStyle", json_integer(displayStyle));
+        json_object_set_new(rootJ, "statsOverlay", json_boolean(statsOverlay));
         json_object_set_new(rootJ, "ajmanEnabled", json_boolean(ajmanEnabled));
+        json_object_set_new(rootJ, "controlRate", json_integer(controlRate));
+        json_object_set_new(rootJ, "asyncReseed", json_boolean(asyncReseed));
+        json_object_set_new(rootJ, "adaptiveIntegrator", json_boolean(adaptiveIntegrator));
+        json_object_set_new(rootJ, "floatEngine", json_boolean(floatEngine));
+        json_object_set_new(rootJ, "fastSine", json_boolean(fastSine));
+        json_object_set_new(rootJ, "windowedBounds", json_boolean(windowedBounds));
+        json_object_set_new(rootJ, "sharedEngine", json_boolean(sharedEngine));
+        json_object_set_new(rootJ, "orbitTables", json_boolean(orbitTables));
+        json_object_set_new(rootJ, "recordFormat", json_integer(recordFormat));
+        json_object_set_new(rootJ, "recordDecimation", json_integer(recordDecimation));
+        json_t* channelsJ = json_array();
+        for (int i = 0; i < 4; i++) {
+            json_array_append_new(channelsJ, json_integer(channels[i]));
+        }
+        json_object_set_new(rootJ, "channels", channelsJ);
+        json_t* audioRateJ = json_array();
+        for (int i = 0; i < 4; i++) {
+            json_array_append_new(audioRateJ, json_boolean(audioRate[i]));
+        }
+        json_object_set_new(rootJ, "audioRate", audioRateJ);
+        // Running state of every voice, so a loaded patch carries on where it was saved
+        json_t* voicesJ = json_array();
+        for (int i = 0; i < 4; i++) {
+            json_t* bankJ = json_array();
+            for (int c = 0; c < activeChannels[i]; c++) {
+                json_array_append_new(bankJ, voiceToJson(i, c));
+            }
+            json_array_append_new(voicesJ, bankJ);
+        }
+        json_object_set_new(rootJ, "voices", voicesJ);
         return rootJ;
     }
 
+    static json_t* realsToJson(const double* values, int count) {
+        json_t* arrayJ = json_array();
+        for (int k = 0; k < count; k++) {
+            json_array_append_new(arrayJ, json_real(values[k]));
+        }
+        return arrayJ;
+    }
+
+    // Reads exactly `count` finite numbers
+    static bool realsFromJson(json_t* arrayJ, double* values, int count) {
+        if (!json_is_array(arrayJ) || (int)json_array_size(arrayJ) != count)
+            return false;
+        for (int k = 0; k < count; k++) {
+            json_t* valueJ = json_array_get(arrayJ, k);
+            if (!json_is_number(valueJ))
+                return false;
+            values[k] = json_number_value(valueJ);
+            if (!std::isfinite(values[k]))
+                return false;
+        }
+        return true;
+    }
+
+    json_t* voiceToJson(int bank, int c) {
+        const Attractor& a = attractors[bank][c];
+        double state[3] = {a.x, a.y, a.z};
+        double bounds[6] = {a.minX, a.maxX, a.minY, a.maxY, a.minZ, a.maxZ};
+        double smoothed[3] = {smoothedX[bank][c], smoothedY[bank][c], smoothedZ[bank][c]};
+        json_t* voiceJ = json_object();
+        json_object_set_new(voiceJ, "type", json_integer(a.type));
+        json_object_set_new(voiceJ, "chaos", json_real(a.chaos));
+        json_object_set_new(voiceJ, "state", realsToJson(state, 3));
+        json_object_set_new(voiceJ, "bounds", realsToJson(bounds, 6));
+        json_object_set_new(voiceJ, "smoothed", realsToJson(smoothed, 3));
+        json_object_set_new(voiceJ, "adaptiveStep", json_real(a.adaptiveH));
+        return voiceJ;
+    }
+
+    // Restore a voice saved by voiceToJson in place of a re-seed. Returns false, leaving
+    // the voice alone, if the entry is incomplete or not a usable state.
+    bool voiceFromJson(int bank, int c, json_t* voiceJ) {
+        json_t* typeJ = json_object_get(voiceJ, "type");
+        json_t* chaosJ = json_object_get(voiceJ, "chaos");
+        json_t* stepJ = json_object_get(voiceJ, "adaptiveStep");
+        double state[3], bounds[6], smoothed[3];
+        if (!json_is_integer(typeJ) || !json_is_number(chaosJ) ||
+            !realsFromJson(json_object_get(voiceJ, "state"), state, 3) ||
+            !realsFromJson(json_object_get(voiceJ, "bounds"), bounds, 6) ||
+            !realsFromJson(json_object_get(voiceJ, "smoothed"), smoothed, 3))
+            return false;
+        int type = json_integer_value(typeJ);
+        if (type < SPROTT_B || type > DADRAS || Attractor::isRunaway(state[0], state[1], state[2]))
+            return false;
+        for (int k = 0; k < 6; k += 2) {
+            if (!(bounds[k] < bounds[k + 1]))
+                return false;
+        }
+
+        Attractor& a = attractors[bank][c];
+        a = Attractor();
+        a.type = (AttractorType)type;
+        a.stepFn = Attractor::stepperFor(a.type);
+        a.chaos = clamp((float)json_number_value(chaosJ), 0.f, 1.f);
+        a.x = state[0]; a.y = state[1]; a.z = state[2];
+        a.minX = bounds[0]; a.maxX = bounds[1];
+        a.minY = bounds[2]; a.maxY = bounds[3];
+        a.minZ = bounds[4]; a.maxZ = bounds[5];
+        if (json_is_number(stepJ) && json_number_value(stepJ) > 0.0) {
+            a.adaptiveH = json_number_value(stepJ);
+        }
+        fadeAmount[bank][c] = 0.f;
+        forceReseed[bank][c] = false;
+        smoothedX[bank][c] = prevSmoothedX[bank][c] = clamp((float)smoothed[0], -1.f, 1.f);
+        smoothedY[bank][c] = prevSmoothedY[bank][c] = clamp((float)smoothed[1], -1.f, 1.f);
+        smoothedZ[bank][c] = prevSmoothedZ[bank][c] = clamp((float)smoothed[2], -1.f, 1.f);
+        return true;
+    }
+
     void dataFromJson(json_t* rootJ) override {
         json_t* displayModeJ = json_object_get(rootJ, "displayMode");
         if (displayModeJ) {
@@ -658,41 +1473,313 @@ struct StrangeWeather : Module {
         if (displayStyleJ) {
             displayStyle = json_integer_value(displayStyleJ);
         }
+        json_t* statsOverlayJ = json_object_get(rootJ, "statsOverlay");
+        if (statsOverlayJ) {
+            statsOverlay = json_boolean_value(statsOverlayJ);
+        }
         json_t* ajmanEnabledJ = json_object_get(rootJ, "ajmanEnabled");
         if (ajmanEnabledJ) {
             ajmanEnabled = json_boolean_value(ajmanEnabledJ);
         }
+        json_t* controlRateJ = json_object_get(rootJ, "controlRate");
+        if (controlRateJ) {
+            controlRate = clamp((int)json_integer_value(controlRateJ), 0, NUM_CONTROL_RATES - 1);
+        }
+        json_t* asyncReseedJ = json_object_get(rootJ, "asyncReseed");
+        if (asyncReseedJ) {
+            asyncReseed = json_boolean_value(asyncReseedJ);
+        }
+        json_t* adaptiveIntegratorJ = json_object_get(rootJ, "adaptiveIntegrator");
+        if (adaptiveIntegratorJ) {
+            adaptiveIntegrator = json_boolean_value(adaptiveIntegratorJ);
+        }
+        json_t* floatEngineJ = json_object_get(rootJ, "floatEngine");
+        if (floatEngineJ) {
+            floatEngine = json_boolean_value(floatEngineJ);
+        }
+        json_t* fastSineJ = json_object_get(rootJ, "fastSine");
+        if (fastSineJ) {
+            fastSine = json_boolean_value(fastSineJ);
+        }
+        json_t* windowedBoundsJ = json_object_get(rootJ, "windowedBounds");
+        if (windowedBoundsJ) {
+            windowedBounds = json_boolean_value(windowedBoundsJ);
+        }
+        json_t* sharedEngineJ = json_object_get(rootJ, "sharedEngine");
+        if (sharedEngineJ) {
+            sharedEngine = json_boolean_value(sharedEngineJ);
+        }
+        json_t* orbitTablesJ = json_object_get(rootJ, "orbitTables");
+        if (orbitTablesJ) {
+            setOrbitTables(json_boolean_value(orbitTablesJ));
+        }
+        json_t* recordFormatJ = json_object_get(rootJ, "recordFormat");
+        if (recordFormatJ) {
+            recordFormat = clamp((int)json_integer_value(recordFormatJ), 0, 1);
+        }
+        json_t* recordDecimationJ = json_object_get(rootJ, "recordDecimation");
+        if (recordDecimationJ) {
+            recordDecimation = clamp((int)json_integer_value(recordDecimationJ), 0, NUM_RECORD_DECIMATIONS - 1);
+        }
+        json_t* channelsJ = json_object_get(rootJ, "channels");
+        if (channelsJ) {
+            for (int i = 0; i < 4; i++) {
+                json_t* channelJ = json_array_get(channelsJ, i);
+                if (channelJ) {
+                    channels[i] = clamp((int)json_integer_value(channelJ), 1, MAX_CHANNELS);
+                }
+            }
+        }
+        json_t* audioRateJ = json_object_get(rootJ, "audioRate");
+        if (audioRateJ) {
+            for (int i = 0; i < 4; i++) {
+                json_t* bankJ = json_array_get(audioRateJ, i);
+                if (bankJ) {
+                    audioRate[i] = json_boolean_value(bankJ);
+                }
+            }
+        }
+        // Voices left out (older patches, or more channels than were saved) are seeded
+        // as usual on the first frame
+        json_t* voicesJ = json_object_get(rootJ, "voices");
+        if (voicesJ) {
+            for (int i = 0; i < 4; i++) {
+                json_t* bankJ = json_array_get(voicesJ, i);
+                int restored = 0;
+                while (restored < channels[i] && voiceFromJson(i, restored, json_array_get(bankJ, restored))) {
+                    restored++;
+                }
+                if (restored > 0) {
+                    activeChannels[i] = restored;
+                }
+            }
+        }
+    }
+};
+
+
+// Rotation about Y then X followed by a simple perspective divide, for the 3D display.
+// The matrix is built once per frame and project() maps trail points four at a time.
+struct View3D {
+    // Rows give rotated x, rotated y and depth
+    float m[3][3] = {{1.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 0.f, 1.f}};
+
+    void setAngles(float angleX, float angleY) {
+        float cosX = std::cos(angleX), sinX = std::sin(angleX);
+        float cosY = std::cos(angleY), sinY = std::sin(angleY);
+        m[0][0] = cosY;         m[0][1] = 0.f;   m[0][2] = -sinY;
+        m[1][0] = -sinX * sinY; m[1][1] = cosX;  m[1][2] = -sinX * cosY;
+        m[2][0] = cosX * sinY;  m[2][1] = sinX;  m[2][2] = cosX * cosY;
+    }
+
+    // Project the newest `count` samples of a trail source, newest first, into screen
+    // coordinates (centered, unit scale) and depth (larger = farther). The outputs must
+    // hold `count` rounded up to a multiple of 4.
+    void project(const TrailSnapshot& trail, int source, int count, float* screenX, float* screenY, float* depth) const {
+        const TrailPoint* points = trail.points[source];
+        for (int i = 0; i < count; i += 4) {
+            // Pad the last group with the oldest requested sample
+            const TrailPoint& p0 = points[trail.slot(i)];
+            const TrailPoint& p1 = points[trail.slot(std::min(i + 1, count - 1))];
+            const TrailPoint& p2 = points[trail.slot(std::min(i + 2, count - 1))];
+            const TrailPoint& p3 = points[trail.slot(std::min(i + 3, count - 1))];
+            simd::float_4 x(p0.x(), p1.x(), p2.x(), p3.x());
+            simd::float_4 y(p0.y(), p1.y(), p2.y(), p3.y());
+            simd::float_4 z(p0.z(), p1.z(), p2.z(), p3.z());
+
+            simd::float_4 rx = x * m[0][0] + y * m[0][1] + z * m[0][2];
+            simd::float_4 ry = x * m[1][0] + y * m[1][1] + z * m[1][2];
+            simd::float_4 rz = x * m[2][0] + y * m[2][1] + z * m[2][2];
+
+            // Simple perspective
+            simd::float_4 perspective = 1.f / (1.f + rz * 0.15f);
+            (rx * perspective).store(screenX + i);
+            (ry * perspective).store(screenY + i);
+            rz.store(depth + i);
+        }
+    }
+};
+
+
+// Offscreen NanoVG image covering a widget at the current pixel scale. Rendering goes
+// through the framebuffer context (fbVg) between begin() and end(); draw() paints the
+// image back into the widget.
+struct OffscreenLayer {
+    NVGLUframebuffer* fb = nullptr;
+    int width = 0, height = 0;  // Size in pixels
+    float pixelScale = 1.f;
+
+    ~OffscreenLayer() {
+        release();
+    }
+
+    void release() {
+        if (fb) {
+            nvgluDeleteFramebuffer(fb);
+            fb = nullptr;
+        }
+    }
+
+    static float pixelScaleOf(NVGcontext* vg) {
+        float xform[6];
+        nvgCurrentTransform(vg, xform);
+        return std::sqrt(xform[0] * xform[0] + xform[1] * xform[1]);
+    }
+
+    // Size the framebuffer for `size` at `scale`, creating it in context `vg`. Returns
+    // true if it was recreated, leaving its contents undefined; fb stays null on failure.
+    bool fit(NVGcontext* vg, Vec size, float scale) {
+        int w = (int)std::ceil(size.x * scale);
+        int h = (int)std::ceil(size.y * scale);
+        pixelScale = scale;
+        if (fb && w == width && h == height)
+            return false;
+        release();
+        if (w > 0 && h > 0)
+            fb = nvgluCreateFramebuffer(vg, w, h, 0);
+        width = w;
+        height = h;
+        return true;
+    }
+
+    NVGcontext* begin(bool clear) {
+        nvgluBindFramebuffer(fb);
+        glViewport(0, 0, width, height);
+        if (clear) {
+            glClearColor(0.f, 0.f, 0.f, 0.f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        }
+        NVGcontext* fbVg = APP->window->fbVg;
+        nvgBeginFrame(fbVg, width, height, 1.f);
+        nvgScale(fbVg, pixelScale, pixelScale);
+        return fbVg;
+    }
+
+    void end() {
+        nvgEndFrame(APP->window->fbVg);
+        nvgluBindFramebuffer(NULL);
+    }
+
+    void draw(NVGcontext* vg, Vec size) const {
+        NVGpaint paint = nvgImagePattern(vg, 0.f, 0.f, size.x, size.y, 0.f, fb->image, 1.f);
+        nvgBeginPath(vg);
+        nvgRect(vg, 0.f, 0.f, size.x, size.y);
+        nvgFillPaint(vg, paint);
+        nvgFill(vg);
     }
 };
 
 
-// Custom display widget for attractor visualization
+// Custom display widget for attractor visualization. The display is drawn through a
+// FramebufferWidget child that is only marked dirty when the trail has new samples, the
+// view is rotating or the display settings change; other frames just paint its image.
 struct AttractorDisplay : Widget {
     StrangeWeather* module = nullptr;
     float rotationTime = 0.f;
     int ajmanImage = -1;  // NanoVG image handle for Ajman
+    // Consistent copy of the module's trails, refreshed with the new samples each frame
+    TrailSnapshot trail;
+
+    // 3D view for this frame and the screen-space buffers trails are projected into
+    View3D view;
+    std::vector<float> projX, projY, projDepth;
+    std::vector<int> projKey, projOrder;
+
+    // Phosphor layer for the 2D Lissajous style: an offscreen image holding the dots
+    // plotted so far. Each frame dims it for the samples that arrived and plots only
+    // those, so the cost follows new samples rather than the trail length.
+    static constexpr float PHOSPHOR_FLOOR = 0.02f;     // Brightness at the end of the trail
+    static constexpr float PHOSPHOR_MIN_DIM = 0.9f;    // Dim in steps no finer than this (8-bit rounding)
+    OffscreenLayer phosphor;
+    int phosphorMode = -1;                       // Display mode and trail length it was drawn for
+    int phosphorTrailLen = 0;
+    uint32_t phosphorWritten = 0;                // Trail samples plotted so far
+    int phosphorValid = 0;
+    uint32_t phosphorRebuiltAt = 0;              // Sample count at the last full redraw
+    float phosphorPendingDim = 1.f;              // Dimming owed but not applied yet
+
+    // Draws the whole display into the framebuffer
+    struct Content : Widget {
+        AttractorDisplay* display = nullptr;
+        void draw(const DrawArgs& args) override {
+            display->drawContent(args);
+        }
+    };
+    FramebufferWidget* contentFb;
+    Content* content;
+
+    // Settings the framebuffer was last drawn with
+    int contentMode = -1;
+    int contentStyle = -1;
+    bool content3D = false;
+    int contentTrailLen = 0;
+    bool contentStatsOverlay = false;
+    uint32_t contentStatsGeneration = 0;
+
+    AttractorDisplay() {
+        contentFb = new FramebufferWidget;
+        content = new Content;
+        content->display = this;
+        contentFb->addChild(content);
+        addChild(contentFb);
+    }
+
+    void onContextDestroy(const ContextDestroyEvent& e) override {
+        phosphor.release();
+        Widget::onContextDestroy(e);
+    }
 
-    // 3D projection: rotate point and return screen coordinates
-    void project3D(float x, float y, float z, float angleX, float angleY, float& screenX, float& screenY, float& depth) {
-        // Rotate around Y axis
-        float rx = x * std::cos(angleY) - z * std::sin(angleY);
-        float rz = x * std::sin(angleY) + z * std::cos(angleY);
+    void step() override {
+        contentFb->box.size = content->box.size = box.size;
+        // Module browser previews are drawn once
+        if (module) {
+            bool dirty = trail.update(module->trails);
+
+            // Rotate by real elapsed time so the speed doesn't depend on the frame rate;
+            // long stalls (dragging, loading) don't make the view jump
+            if (module->display3D) {
+                rotationTime += std::min((float)APP->window->getLastFrameDuration(), 0.1f);
+                dirty = true;
+            }
 
-        // Rotate around X axis
-        float ry = y * std::cos(angleX) - rz * std::sin(angleX);
-        float finalZ = y * std::sin(angleX) + rz * std::cos(angleX);
+            int mode = module->displayMode;
+            int trailLen = module->getTrailLength();
+            if (mode != contentMode || module->displayStyle != contentStyle ||
+                module->display3D != content3D || trailLen != contentTrailLen) {
+                dirty = true;
+            }
+            uint32_t statsGeneration = module->statsGeneration.load(std::memory_order_relaxed);
+            if (module->statsOverlay != contentStatsOverlay ||
+                (module->statsOverlay && statsGeneration != contentStatsGeneration)) {
+                dirty = true;
+            }
 
-        // Simple perspective
-        float perspective = 1.0f / (1.0f + finalZ * 0.15f);
-        screenX = rx * perspective;
-        screenY = ry * perspective;
-        depth = finalZ;
+            if (dirty) {
+                contentFb->setDirty();
+                contentMode = mode;
+                contentStyle = module->displayStyle;
+                content3D = module->display3D;
+                contentTrailLen = trailLen;
+                contentStatsOverlay = module->statsOverlay;
+                contentStatsGeneration = statsGeneration;
+            }
+        }
+        Widget::step();
     }
 
     void draw(const DrawArgs& args) override {
-        // Update rotation time for 3D mode
-        rotationTime += 1.f / 60.f;  // Approximate 60fps
+        // The framebuffer renders during Widget::draw, so bring the view and the phosphor
+        // layer it paints up to date first
+        if (module && contentFb->dirty) {
+            view.setAngles(rotationTime * 0.2f, rotationTime * 0.33f);
+            if (module->displayStyle == 1 && !module->display3D && contentMode != 6) {
+                updatePhosphor(contentMode, contentTrailLen, OffscreenLayer::pixelScaleOf(args.vg));
+            }
+        }
+        Widget::draw(args);
+    }
 
+    void drawContent(const DrawArgs& args) {
         // Background
         nvgBeginPath(args.vg);
         nvgRect(args.vg, 0, 0, box.size.x, box.size.y);
@@ -733,6 +1820,11 @@ struct AttractorDisplay : Widget {
         }
         bool is3D = module->display3D;
 
+        // Lissajous dots persist in the phosphor layer instead of being redrawn each frame
+        if (module->displayStyle == 1 && !is3D && phosphor.fb) {
+            phosphor.draw(args.vg, box.size);
+        }
+
         // Setup label style
         nvgFontSize(args.vg, 8);
         nvgFontFaceId(args.vg, APP->window->uiFont->handle);
@@ -797,10 +1889,141 @@ struct AttractorDisplay : Widget {
             nvgText(args.vg, 3, 3, "3D", NULL);
         }
 
+        if (module->statsOverlay) {
+            drawStatsOverlay(args);
+        }
+
         // Restore clipping
         nvgRestore(args.vg);
     }
 
+    // Per-bank engine counters along the bottom of the display
+    void drawStatsOverlay(const DrawArgs& args) {
+        const float lineHeight = 8.f;
+        float top = box.size.y - 4 * lineHeight - 4.f;
+        nvgBeginPath(args.vg);
+        nvgRect(args.vg, 0, top, box.size.x, box.size.y - top);
+        nvgFillColor(args.vg, nvgRGBA(0x00, 0x00, 0x00, 0xaa));
+        nvgFill(args.vg);
+
+        nvgFontSize(args.vg, 7);
+        nvgTextAlign(args.vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+        std::memory_order relaxed = std::memory_order_relaxed;
+        for (int i = 0; i < 4; i++) {
+            const BankStats& stats = module->bankStats[i];
+            std::string line = string::f("%c  %.1f/%.0f steps  cap %u  blow-up %u  %.0f ns",
+                'A' + i, stats.avgSubsteps.load(relaxed), stats.maxSubsteps.load(relaxed),
+                stats.capHits.load(relaxed), stats.blowups.load(relaxed), stats.nsPerSample.load(relaxed));
+            nvgFillColor(args.vg, sourceColor(i));
+            nvgText(args.vg, 3, top + 2.f + i * lineHeight, line.c_str(), NULL);
+        }
+    }
+
+    // Trail sources shown in a display mode and where each is drawn; returns false if
+    // the source isn't visible in that mode
+    bool sourceViewport(int mode, int source, float& ox, float& oy, float& w, float& h) {
+        if (mode == 5) {
+            if (source == TrailBuffer::COMBINED)
+                return false;
+            w = box.size.x / 2.f;
+            h = box.size.y / 2.f;
+            ox = (source % 2) * w;
+            oy = (source / 2) * h;
+            return true;
+        }
+        bool shown = (mode == 4) ? (source == TrailBuffer::COMBINED) : (source == mode);
+        ox = oy = 0.f;
+        w = box.size.x;
+        h = box.size.y;
+        return shown;
+    }
+
+    static NVGcolor sourceColor(int source) {
+        switch (source) {
+            case 0: return nvgRGB(0x00, 0xff, 0xaa);
+            case 1: return nvgRGB(0xff, 0xaa, 0x00);
+            case 2: return nvgRGB(0xaa, 0x00, 0xff);
+            case 3: return nvgRGB(0xff, 0x00, 0x66);
+        }
+        return nvgRGB(0xff, 0xff, 0xff);
+    }
+
+    // Plot Lissajous dots for samples of age [ageBegin, ageEnd), newest first, fading by
+    // `fade` per sample of age
+    void plotDots(NVGcontext* vg, int source, int ageBegin, int ageEnd, float fade,
+                  float ox, float oy, float w, float h) {
+        float cx = ox + w / 2.f;
+        float cy = oy + h / 2.f;
+        float scale = std::min(w, h) / 2.f * 0.75f;
+        NVGcolor color = sourceColor(source);
+        const TrailPoint* points = trail.points[source];
+        float brightness = std::pow(fade, (float)ageBegin);
+        for (int age = ageBegin; age < ageEnd; age++) {
+            const TrailPoint& p = points[trail.slot(age)];
+            nvgBeginPath(vg);
+            nvgCircle(vg, cx + p.x() * scale, cy + p.y() * scale, 0.8f);
+            nvgFillColor(vg, nvgRGBAf(color.r, color.g, color.b, brightness * 0.9f));
+            nvgFill(vg);
+            brightness *= fade;
+        }
+    }
+
+    // Bring the phosphor layer up to date with the trail snapshot. The layer
+    // is redrawn from the whole trail when it can't be updated incrementally (new size,
+    // mode or trail length, a cleared trail, or too many samples missed) and once per
+    // trail length of samples, which also flushes dots stuck by 8-bit rounding.
+    // Its image is drawn inside the content framebuffer, so it belongs to the framebuffer context.
+    void updatePhosphor(int mode, int trailLen, float pixelScale) {
+        bool rebuild = phosphor.fit(APP->window->fbVg, box.size, pixelScale);
+        if (!phosphor.fb)
+            return;
+        uint32_t newSamples = trail.written - phosphorWritten;
+        int expectedValid = std::min(phosphorValid + (int)std::min(newSamples, (uint32_t)TrailBuffer::LENGTH), TrailBuffer::LENGTH);
+        if (mode != phosphorMode || trailLen != phosphorTrailLen || trail.valid < expectedValid ||
+            newSamples >= (uint32_t)trailLen || trail.written - phosphorRebuiltAt >= (uint32_t)trailLen) {
+            rebuild = true;
+        }
+
+        if (rebuild || newSamples > 0) {
+            float fade = std::pow(PHOSPHOR_FLOOR, 1.f / trailLen);
+            NVGcontext* fbVg = phosphor.begin(rebuild);
+
+            int ageEnd = trailLen;
+            if (rebuild) {
+                phosphorPendingDim = 1.f;
+                phosphorRebuiltAt = trail.written;
+            }
+            else {
+                // Multiply the existing image down; small steps would round away in 8 bits
+                phosphorPendingDim *= std::pow(fade, (float)newSamples);
+                if (phosphorPendingDim <= PHOSPHOR_MIN_DIM) {
+                    nvgBeginPath(fbVg);
+                    nvgRect(fbVg, 0, 0, box.size.x, box.size.y);
+                    nvgGlobalCompositeOperation(fbVg, NVG_DESTINATION_IN);
+                    nvgFillColor(fbVg, nvgRGBAf(0.f, 0.f, 0.f, phosphorPendingDim));
+                    nvgFill(fbVg);
+                    nvgGlobalCompositeOperation(fbVg, NVG_SOURCE_OVER);
+                    phosphorPendingDim = 1.f;
+                }
+                ageEnd = (int)newSamples;
+            }
+
+            for (int source = 0; source < TrailBuffer::SOURCES; source++) {
+                float ox, oy, w, h;
+                if (sourceViewport(mode, source, ox, oy, w, h)) {
+                    plotDots(fbVg, source, 0, ageEnd, fade, ox, oy, w, h);
+                }
+            }
+
+            phosphor.end();
+
+            phosphorMode = mode;
+            phosphorTrailLen = trailLen;
+            phosphorWritten = trail.written;
+            phosphorValid = trail.valid;
+        }
+    }
+
     void drawPreview(const DrawArgs& args) {
         nvgBeginPath(args.vg);
         float cx = box.size.x / 2.f;
@@ -828,102 +2051,188 @@ struct AttractorDisplay : Widget {
         float cy = oy + h / 2.f;
         float scale = std::min(w, h) / 2.f * 0.75f;  // 75% to stay within bounds
 
-        int idx = module->trailIndex;
         int style = module->displayStyle;
 
-        // Rotation angles for 3D mode
-        float angleX = rotationTime * 0.2f;
-        float angleY = rotationTime * 0.33f;
-
         int trailLen = module->getTrailLength();
 
         if (style == 2) {
             // Scope mode: time-based waveforms (X, Y, Z stacked)
-            float rowH = h / 3.f;
-            float* data[3] = {module->trailX[bank], module->trailY[bank], module->trailZ[bank]};
-
-            for (int row = 0; row < 3; row++) {
-                float baseY = oy + rowH * row + rowH / 2.f;
-                float waveScale = rowH * 0.4f;
+            drawScope(args, bank, trailLen, ox, oy, w, h, color);
+        }
+        else if (style == 1 && !is3D) {
+            // Lissajous mode (style 1): kept in the phosphor layer, see updatePhosphor()
+        }
+        else if (is3D) {
+            // 3D mode: tiny dots, depth-shaded and drawn back to front
+            drawDots3D(args, bank, trailLen, cx, cy, scale, color, (style == 1) ? 0.8f : 1.5f);
+        }
+        else {
+            // Trace mode (style 0): lines
+            drawTrace(args, bank, trailLen, cx, cy, scale, color);
+        }
+    }
+    
+    // Scope style: x, y and z against time in three stacked rows. A trail longer than two
+    // samples per pixel column is drawn from the snapshot's min/max pyramid instead, as
+    // each column's extremes in the order they were reached, so the vertex count follows
+    // the width and peaks aren't lost.
+    void drawScope(const DrawArgs& args, int source, int trailLen, float ox, float oy, float w, float h, NVGcolor color) {
+        const TrailPoint* points = trail.points[source];
+        float rowH = h / 3.f;
+        int columns = std::max((int)w, 1);
+        bool decimate = trailLen > 2 * columns;
+
+        for (int row = 0; row < 3; row++) {
+            float baseY = oy + rowH * row + rowH / 2.f;
+            float waveScale = rowH * 0.4f;
 
-                nvgBeginPath(args.vg);
+            nvgBeginPath(args.vg);
+            if (!decimate) {
                 for (int i = 0; i < trailLen; i++) {
-                    int i0 = (idx - trailLen + 1 + i + StrangeWeather::MAX_TRAIL_LENGTH) % StrangeWeather::MAX_TRAIL_LENGTH;
+                    int i0 = trail.slot(trailLen - 1 - i);
                     float xPos = ox + (float)i / trailLen * w;
-                    float yPos = baseY + data[row][i0] * waveScale;
+                    float yPos = baseY + points[i0].get(row) * waveScale;
                     if (i == 0)
                         nvgMoveTo(args.vg, xPos, yPos);
                     else
                         nvgLineTo(args.vg, xPos, yPos);
                 }
-                nvgStrokeColor(args.vg, nvgRGBAf(color.r, color.g, color.b, 0.8f));
-                nvgStrokeWidth(args.vg, 1.f);
-                nvgStroke(args.vg);
             }
-        }
-        else if (style == 1 || is3D) {
-            // Lissajous mode (style 1) or 3D mode: tiny dots
-            for (int i = 0; i < trailLen; i++) {
-                int i0 = (idx - i + StrangeWeather::MAX_TRAIL_LENGTH) % StrangeWeather::MAX_TRAIL_LENGTH;
-
-                float x, y;
-                if (is3D) {
-                    float sx, sy, depth;
-                    project3D(module->trailX[bank][i0], module->trailY[bank][i0], module->trailZ[bank][i0],
-                             angleX, angleY, sx, sy, depth);
-                    x = cx + sx * scale;
-                    y = cy + sy * scale;
-                } else {
-                    x = cx + module->trailX[bank][i0] * scale;
-                    y = cy + module->trailY[bank][i0] * scale;
+            else {
+                for (int c = 0; c < columns; c++) {
+                    // Samples first..last, oldest first, fall in this column
+                    int first = c * trailLen / columns;
+                    int last = (c + 1) * trailLen / columns - 1;
+                    float lo, hi;
+                    trail.extremes(source, row, trailLen - 1 - last, trailLen - 1 - first, lo, hi);
+                    bool rising = points[trail.slot(trailLen - 1 - last)].get(row) >=
+                                  points[trail.slot(trailLen - 1 - first)].get(row);
+                    float x0 = ox + (float)first / trailLen * w;
+                    float x1 = ox + 0.5f * (first + last + 1) / trailLen * w;
+                    float y0 = baseY + (rising ? lo : hi) * waveScale;
+                    float y1 = baseY + (rising ? hi : lo) * waveScale;
+                    if (c == 0)
+                        nvgMoveTo(args.vg, x0, y0);
+                    else
+                        nvgLineTo(args.vg, x0, y0);
+                    nvgLineTo(args.vg, x1, y1);
                 }
+            }
+            nvgStrokeColor(args.vg, nvgRGBAf(color.r, color.g, color.b, 0.8f));
+            nvgStrokeWidth(args.vg, 1.f);
+            nvgStroke(args.vg);
+        }
+    }
 
-                // Age-based fade
-                float age = (float)i / trailLen;
-                float brightness = 1.f - age;
-                brightness = brightness * brightness;
-
-                // Tiny dots for Lissajous phosphor look
-                float dotSize = (style == 1) ? 0.8f : 1.5f;
+    // Trace style: the trail as connected lines fading with age. Segments are grouped
+    // into TRACE_BUCKETS age bands, each stroked as one polyline at the band's mid-age
+    // alpha and width, so the draw-call count doesn't grow with the trail length. Points
+    // closer than TRACE_MIN_STEP pixels to the last one drawn are skipped, which keeps
+    // the vertex count near the length of the curve on screen.
+    static const int TRACE_BUCKETS = 16;
+    static constexpr float TRACE_MIN_STEP = 1.f;
+
+    void drawTrace(const DrawArgs& args, int source, int trailLen, float cx, float cy, float scale, NVGcolor color) {
+        const TrailPoint* points = trail.points[source];
+        int segments = trailLen - 1;
+        for (int b = 0; b < TRACE_BUCKETS; b++) {
+            // Band b covers segments [first, last), i.e. points first..last by age
+            int first = b * segments / TRACE_BUCKETS;
+            int last = (b + 1) * segments / TRACE_BUCKETS;
+            if (last <= first)
+                continue;
+
+            float alpha = 1.f - 0.5f * (first + last) / trailLen;
+            alpha = alpha * alpha * 0.8f;
 
-                nvgBeginPath(args.vg);
-                nvgCircle(args.vg, x, y, dotSize);
-                nvgFillColor(args.vg, nvgRGBAf(color.r, color.g, color.b, brightness * 0.9f));
-                nvgFill(args.vg);
+            nvgBeginPath(args.vg);
+            float lastX = 0.f, lastY = 0.f;
+            for (int i = first; i <= last; i++) {
+                const TrailPoint& p = points[trail.slot(i)];
+                float x = cx + p.x() * scale;
+                float y = cy + p.y() * scale;
+                // Always keep the band's ends, so neighbouring bands still join up
+                if (i == first) {
+                    nvgMoveTo(args.vg, x, y);
+                }
+                else if (i == last || (x - lastX) * (x - lastX) + (y - lastY) * (y - lastY) >= TRACE_MIN_STEP * TRACE_MIN_STEP) {
+                    nvgLineTo(args.vg, x, y);
+                }
+                else {
+                    continue;
+                }
+                lastX = x;
+                lastY = y;
             }
+            nvgStrokeColor(args.vg, nvgRGBAf(color.r, color.g, color.b, alpha));
+            nvgStrokeWidth(args.vg, 1.f + alpha);
+            nvgStroke(args.vg);
         }
-        else {
-            // Trace mode (style 0): lines
-            for (int i = 0; i < trailLen - 1; i++) {
-                int i0 = (idx - i + StrangeWeather::MAX_TRAIL_LENGTH) % StrangeWeather::MAX_TRAIL_LENGTH;
-                int i1 = (idx - i - 1 + StrangeWeather::MAX_TRAIL_LENGTH) % StrangeWeather::MAX_TRAIL_LENGTH;
 
-                float alpha = 1.f - (float)i / trailLen;
-                alpha = alpha * alpha * 0.8f;
+        // Current position dot
+        const TrailPoint& head = points[trail.index];
+        nvgBeginPath(args.vg);
+        nvgCircle(args.vg, cx + head.x() * scale, cy + head.y() * scale, 2.f);
+        nvgFillColor(args.vg, color);
+        nvgFill(args.vg);
+    }
 
-                float x0 = cx + module->trailX[bank][i0] * scale;
-                float y0 = cy + module->trailY[bank][i0] * scale;
-                float x1 = cx + module->trailX[bank][i1] * scale;
-                float y1 = cy + module->trailY[bank][i1] * scale;
+    // 3D dots are bucketed by depth layer (farthest first) and age band and each bucket
+    // is filled as one path, so the draw calls don't grow with the trail length
+    static const int DEPTH_LAYERS = 8;
+    static const int AGE_BANDS = 16;
+    static constexpr float DEPTH_RANGE = 1.75f;  // Max |depth| of a point in the unit cube, rounded up
+
+    void drawDots3D(const DrawArgs& args, int source, int trailLen, float cx, float cy, float scale,
+                    NVGcolor color, float dotSize) {
+        int padded = (trailLen + 3) / 4 * 4;
+        if ((int)projX.size() < padded) {
+            projX.resize(padded);
+            projY.resize(padded);
+            projDepth.resize(padded);
+            projKey.resize(padded);
+            projOrder.resize(padded);
+        }
+        view.project(trail, source, trailLen, projX.data(), projY.data(), projDepth.data());
+
+        // Counting sort of the samples into buckets
+        const int numBuckets = DEPTH_LAYERS * AGE_BANDS;
+        int bucketStart[numBuckets + 1] = {};
+        for (int i = 0; i < trailLen; i++) {
+            float d = clamp(projDepth[i], -DEPTH_RANGE, DEPTH_RANGE);
+            int layer = std::min((int)((DEPTH_RANGE - d) / (2.f * DEPTH_RANGE) * DEPTH_LAYERS), DEPTH_LAYERS - 1);
+            int band = i * AGE_BANDS / trailLen;
+            projKey[i] = layer * AGE_BANDS + band;
+            bucketStart[projKey[i] + 1]++;
+        }
+        for (int k = 0; k < numBuckets; k++) {
+            bucketStart[k + 1] += bucketStart[k];
+        }
+        int fill[numBuckets];
+        std::copy(bucketStart, bucketStart + numBuckets, fill);
+        for (int i = 0; i < trailLen; i++) {
+            projOrder[fill[projKey[i]]++] = i;
+        }
 
-                nvgBeginPath(args.vg);
-                nvgMoveTo(args.vg, x0, y0);
-                nvgLineTo(args.vg, x1, y1);
-                nvgStrokeColor(args.vg, nvgRGBAf(color.r, color.g, color.b, alpha));
-                nvgStrokeWidth(args.vg, 1.f + alpha);
-                nvgStroke(args.vg);
-            }
+        for (int k = 0; k < numBuckets; k++) {
+            if (bucketStart[k] == bucketStart[k + 1])
+                continue;
+            // Age-based fade at the band's middle; nearer layers are brighter
+            float age = ((k % AGE_BANDS) + 0.5f) / AGE_BANDS;
+            float brightness = (1.f - age) * (1.f - age);
+            float nearness = ((k / AGE_BANDS) + 0.5f) / DEPTH_LAYERS;
+            float shade = 0.35f + 0.65f * nearness;
 
-            // Current position dot
-            float x = cx + module->trailX[bank][idx] * scale;
-            float y = cy + module->trailY[bank][idx] * scale;
             nvgBeginPath(args.vg);
-            nvgCircle(args.vg, x, y, 2.f);
-            nvgFillColor(args.vg, color);
+            for (int j = bucketStart[k]; j < bucketStart[k + 1]; j++) {
+                int i = projOrder[j];
+                nvgCircle(args.vg, cx + projX[i] * scale, cy + projY[i] * scale, dotSize);
+            }
+            nvgFillColor(args.vg, nvgRGBAf(color.r, color.g, color.b, brightness * shade * 0.9f));
             nvgFill(args.vg);
         }
     }
-    
+
     void drawCombined(const DrawArgs& args, float ox, float oy, float w, float h, NVGcolor color, bool is3D) {
         if (!module) return;
 
@@ -931,99 +2240,24 @@ struct AttractorDisplay : Widget {
         float cy = oy + h / 2.f;
         float scale = std::min(w, h) / 2.f * 0.75f;  // 75% to stay within bounds
 
-        int idx = module->trailIndex;
         int style = module->displayStyle;
 
-        // Rotation angles for 3D mode (slower, more contemplative)
-        float angleX = rotationTime * 0.2f;
-        float angleY = rotationTime * 0.33f;
-
         int trailLen = module->getTrailLength();
 
         if (style == 2) {
             // Scope mode: time-based waveforms (X, Y, Z stacked)
-            float rowH = h / 3.f;
-            float* data[3] = {module->combTrailX, module->combTrailY, module->combTrailZ};
-
-            for (int row = 0; row < 3; row++) {
-                float baseY = oy + rowH * row + rowH / 2.f;
-                float waveScale = rowH * 0.4f;
-
-                nvgBeginPath(args.vg);
-                for (int i = 0; i < trailLen; i++) {
-                    int i0 = (idx - trailLen + 1 + i + StrangeWeather::MAX_TRAIL_LENGTH) % StrangeWeather::MAX_TRAIL_LENGTH;
-                    float xPos = ox + (float)i / trailLen * w;
-                    float yPos = baseY + data[row][i0] * waveScale;
-                    if (i == 0)
-                        nvgMoveTo(args.vg, xPos, yPos);
-                    else
-                        nvgLineTo(args.vg, xPos, yPos);
-                }
-                nvgStrokeColor(args.vg, nvgRGBAf(color.r, color.g, color.b, 0.8f));
-                nvgStrokeWidth(args.vg, 1.f);
-                nvgStroke(args.vg);
-            }
+            drawScope(args, TrailBuffer::COMBINED, trailLen, ox, oy, w, h, color);
         }
-        else if (style == 1 || is3D) {
-            // Lissajous mode (style 1) or 3D mode: tiny dots
-            for (int i = 0; i < trailLen; i++) {
-                int i0 = (idx - i + StrangeWeather::MAX_TRAIL_LENGTH) % StrangeWeather::MAX_TRAIL_LENGTH;
-
-                float x, y;
-                if (is3D) {
-                    float sx, sy, depth;
-                    project3D(module->combTrailX[i0], module->combTrailY[i0], module->combTrailZ[i0],
-                             angleX, angleY, sx, sy, depth);
-                    x = cx + sx * scale;
-                    y = cy + sy * scale;
-                } else {
-                    x = cx + module->combTrailX[i0] * scale;
-                    y = cy + module->combTrailY[i0] * scale;
-                }
-
-                // Age-based fade
-                float age = (float)i / trailLen;
-                float brightness = 1.f - age;
-                brightness = brightness * brightness;
-
-                // Tiny dots for Lissajous phosphor look
-                float dotSize = (style == 1) ? 0.8f : 1.5f;
-
-                nvgBeginPath(args.vg);
-                nvgCircle(args.vg, x, y, dotSize);
-                nvgFillColor(args.vg, nvgRGBAf(color.r, color.g, color.b, brightness * 0.9f));
-                nvgFill(args.vg);
-            }
+        else if (style == 1 && !is3D) {
+            // Lissajous mode (style 1): kept in the phosphor layer, see updatePhosphor()
+        }
+        else if (is3D) {
+            // 3D mode: tiny dots, depth-shaded and drawn back to front
+            drawDots3D(args, TrailBuffer::COMBINED, trailLen, cx, cy, scale, color, (style == 1) ? 0.8f : 1.5f);
         }
         else {
             // Trace mode (style 0): lines
-            for (int i = 0; i < trailLen - 1; i++) {
-                int i0 = (idx - i + StrangeWeather::MAX_TRAIL_LENGTH) % StrangeWeather::MAX_TRAIL_LENGTH;
-                int i1 = (idx - i - 1 + StrangeWeather::MAX_TRAIL_LENGTH) % StrangeWeather::MAX_TRAIL_LENGTH;
-
-                float alpha = 1.f - (float)i / trailLen;
-                alpha = alpha * alpha * 0.8f;
-
-                float x0 = cx + module->combTrailX[i0] * scale;
-                float y0 = cy + module->combTrailY[i0] * scale;
-                float x1 = cx + module->combTrailX[i1] * scale;
-                float y1 = cy + module->combTrailY[i1] * scale;
-
-                nvgBeginPath(args.vg);
-                nvgMoveTo(args.vg, x0, y0);
-                nvgLineTo(args.vg, x1, y1);
-                nvgStrokeColor(args.vg, nvgRGBAf(color.r, color.g, color.b, alpha));
-                nvgStrokeWidth(args.vg, 1.f + alpha);
-                nvgStroke(args.vg);
-            }
-
-            // Current position dot
-            float x = cx + module->combTrailX[idx] * scale;
-            float y = cy + module->combTrailY[idx] * scale;
-            nvgBeginPath(args.vg);
-            nvgCircle(args.vg, x, y, 2.f);
-            nvgFillColor(args.vg, color);
-            nvgFill(args.vg);
+            drawTrace(args, TrailBuffer::COMBINED, trailLen, cx, cy, scale, color);
         }
     }
 };
@@ -1154,6 +2388,14 @@ struct PanelLabels : Widget {
         nvgFillColor(args.vg, nvgRGB(0xcc, 0x00, 0x44));
         nvgText(args.vg, mm2px(77), mm2px(96), "D", NULL);
 
+        // CV labels, to the left of the RATE and CHAOS CV jacks 11mm under each knob
+        nvgFontSize(args.vg, 7);
+        nvgFillColor(args.vg, nvgRGB(0x44, 0x44, 0x44));
+        for (float bankY : {24.f, 48.f, 72.f, 96.f}) {
+            nvgText(args.vg, mm2px(80), mm2px(bankY + 11), "CV", NULL);
+            nvgText(args.vg, mm2px(134), mm2px(bankY + 11), "CV", NULL);
+        }
+
         // CYCLE, MODE, 3D, and TRAIL labels (below display, centered on 35mm)
         nvgFontSize(args.vg, 8);
         nvgTextAlign(args.vg, NVG_ALIGN_CENTER | NVG_ALIGN_TOP);
@@ -1206,11 +2448,15 @@ struct StrangeWeatherWidget : ModuleWidget {
         addChild(createWidget<ScrewSilver>(Vec(RACK_GRID_WIDTH, RACK_GRID_HEIGHT - RACK_GRID_WIDTH)));
         addChild(createWidget<ScrewSilver>(Vec(box.size.x - 2 * RACK_GRID_WIDTH, RACK_GRID_HEIGHT - RACK_GRID_WIDTH)));
 
-        // Panel labels (drawn with NanoVG)
+        // Panel labels (drawn with NanoVG once, then cached in a framebuffer)
+        FramebufferWidget* labelsFb = new FramebufferWidget();
+        labelsFb->box.pos = Vec(0, 0);
+        labelsFb->box.size = box.size;
         PanelLabels* labels = new PanelLabels();
         labels->box.pos = Vec(0, 0);
         labels->box.size = box.size;
-        addChild(labels);
+        labelsFb->addChild(labels);
+        addChild(labelsFb);
 
         // Display (large 60x60mm square)
         display = new AttractorDisplay();
@@ -1246,6 +2492,9 @@ struct StrangeWeatherWidget : ModuleWidget {
         //         Voltage toggle (4-pos), Chaos knob, then 4 outputs
         // All x positions shifted +30mm for 36HP panel
 
+        // RATE and CHAOS CV jacks sit under their knobs
+        const float CV_OFFSET = 11.0;
+
         // Bank A controls and outputs (y = 24mm center)
         // 40HP panel = 203.2mm wide. Controls start at 85mm to leave room for labels
         float yA = 24.0;
@@ -1254,6 +2503,8 @@ struct StrangeWeatherWidget : ModuleWidget {
         addParam(createParamCentered<CKSSFour>(mm2px(Vec(112.0, yA)), module, StrangeWeather::SHAPE_A_PARAM));
         addParam(createParamCentered<CKSSFour>(mm2px(Vec(124.0, yA)), module, StrangeWeather::VOLTAGE_A_PARAM));
         addParam(createParamCentered<DaviesKnob>(mm2px(Vec(139.0, yA)), module, StrangeWeather::CHAOS_A_PARAM));
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(85.0, yA + CV_OFFSET)), module, StrangeWeather::RATE_A_INPUT));
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(139.0, yA + CV_OFFSET)), module, StrangeWeather::CHAOS_A_INPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(158.0, yA)), module, StrangeWeather::A_X_OUTPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(170.0, yA)), module, StrangeWeather::A_Y_OUTPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(182.0, yA)), module, StrangeWeather::A_Z_OUTPUT));
@@ -1266,6 +2517,8 @@ struct StrangeWeatherWidget : ModuleWidget {
         addParam(createParamCentered<CKSSFour>(mm2px(Vec(112.0, yB)), module, StrangeWeather::SHAPE_B_PARAM));
         addParam(createParamCentered<CKSSFour>(mm2px(Vec(124.0, yB)), module, StrangeWeather::VOLTAGE_B_PARAM));
         addParam(createParamCentered<DaviesKnob>(mm2px(Vec(139.0, yB)), module, StrangeWeather::CHAOS_B_PARAM));
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(85.0, yB + CV_OFFSET)), module, StrangeWeather::RATE_B_INPUT));
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(139.0, yB + CV_OFFSET)), module, StrangeWeather::CHAOS_B_INPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(158.0, yB)), module, StrangeWeather::B_X_OUTPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(170.0, yB)), module, StrangeWeather::B_Y_OUTPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(182.0, yB)), module, StrangeWeather::B_Z_OUTPUT));
@@ -1278,6 +2531,8 @@ struct StrangeWeatherWidget : ModuleWidget {
         addParam(createParamCentered<CKSSFour>(mm2px(Vec(112.0, yC)), module, StrangeWeather::SHAPE_C_PARAM));
         addParam(createParamCentered<CKSSFour>(mm2px(Vec(124.0, yC)), module, StrangeWeather::VOLTAGE_C_PARAM));
         addParam(createParamCentered<DaviesKnob>(mm2px(Vec(139.0, yC)), module, StrangeWeather::CHAOS_C_PARAM));
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(85.0, yC + CV_OFFSET)), module, StrangeWeather::RATE_C_INPUT));
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(139.0, yC + CV_OFFSET)), module, StrangeWeather::CHAOS_C_INPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(158.0, yC)), module, StrangeWeather::C_X_OUTPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(170.0, yC)), module, StrangeWeather::C_Y_OUTPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(182.0, yC)), module, StrangeWeather::C_Z_OUTPUT));
@@ -1290,6 +2545,8 @@ struct StrangeWeatherWidget : ModuleWidget {
         addParam(createParamCentered<CKSSFour>(mm2px(Vec(112.0, yD)), module, StrangeWeather::SHAPE_D_PARAM));
         addParam(createParamCentered<CKSSFour>(mm2px(Vec(124.0, yD)), module, StrangeWeather::VOLTAGE_D_PARAM));
         addParam(createParamCentered<DaviesKnob>(mm2px(Vec(139.0, yD)), module, StrangeWeather::CHAOS_D_PARAM));
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(85.0, yD + CV_OFFSET)), module, StrangeWeather::RATE_D_INPUT));
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(139.0, yD + CV_OFFSET)), module, StrangeWeather::CHAOS_D_INPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(158.0, yD)), module, StrangeWeather::D_X_OUTPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(170.0, yD)), module, StrangeWeather::D_Y_OUTPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(182.0, yD)), module, StrangeWeather::D_Z_OUTPUT));
@@ -1324,6 +2581,117 @@ struct StrangeWeatherWidget : ModuleWidget {
 
         menu->addChild(createBoolPtrMenuItem("3D Rotation", "", &module->display3D));
 
+        menu->addChild(new MenuSeparator());
+        menu->addChild(createMenuLabel("Engine"));
+
+        menu->addChild(createIndexSubmenuItem("Control rate",
+            {"Every sample", "Every 16 samples", "Every 32 samples", "Every 64 samples"},
+            [=]() { return module->controlRate; },
+            [=](int rate) { module->controlRate = rate; }
+        ));
+
+        menu->addChild(createBoolPtrMenuItem("Re-seed in background", "", &module->asyncReseed));
+        menu->addChild(createBoolPtrMenuItem("Adaptive integrator", "", &module->adaptiveIntegrator));
+        menu->addChild(createIndexSubmenuItem("Precision",
+            {"Double (reference)", "Single"},
+            [=]() { return module->floatEngine ? 1 : 0; },
+            [=](int precision) { module->floatEngine = precision == 1; }
+        ));
+        menu->addChild(createIndexSubmenuItem("Thomas sine",
+            {"Exact (std::sin)", "Fast (polynomial)"},
+            [=]() { return module->fastSine ? 1 : 0; },
+            [=](int mode) { module->fastSine = mode == 1; }
+        ));
+        menu->addChild(createIndexSubmenuItem("Normalization",
+            {"Expand only (reference)", "Sliding window"},
+            [=]() { return module->windowedBounds ? 1 : 0; },
+            [=](int mode) { module->windowedBounds = mode == 1; }
+        ));
+        menu->addChild(createBoolPtrMenuItem("Shared engine (block control rates)", "", &module->sharedEngine));
+        menu->addChild(createBoolMenuItem("Table playback (Low/Med range)", "",
+            [=]() { return module->orbitTables; },
+            [=](bool enabled) { module->setOrbitTables(enabled); }
+        ));
+
+        std::vector<std::string> channelLabels;
+        for (int c = 1; c <= StrangeWeather::MAX_CHANNELS; c++) {
+            channelLabels.push_back(std::to_string(c));
+        }
+        menu->addChild(createSubmenuItem("Polyphony", "", [=](Menu* menu) {
+            const char* bankNames[4] = {"Bank A", "Bank B", "Bank C", "Bank D"};
+            for (int i = 0; i < 4; i++) {
+                menu->addChild(createIndexSubmenuItem(bankNames[i], channelLabels,
+                    [=]() { return module->channels[i] - 1; },
+                    [=](int c) { module->channels[i] = c + 1; }
+                ));
+            }
+        }));
+
+        menu->addChild(createSubmenuItem("Audio rate", "", [=](Menu* menu) {
+            const char* bankNames[4] = {"Bank A", "Bank B", "Bank C", "Bank D"};
+            for (int i = 0; i < 4; i++) {
+                menu->addChild(createBoolPtrMenuItem(bankNames[i], "", &module->audioRate[i]));
+            }
+        }));
+
+        menu->addChild(createSubmenuItem("Engine stats", "", [=](Menu* menu) {
+            std::memory_order relaxed = std::memory_order_relaxed;
+            for (int i = 0; i < 4; i++) {
+                const BankStats& stats = module->bankStats[i];
+                menu->addChild(createMenuLabel(string::f("Bank %c", 'A' + i)));
+                menu->addChild(createMenuLabel(string::f("Substeps per sample: %.2f avg, %.1f max",
+                    stats.avgSubsteps.load(relaxed), stats.maxSubsteps.load(relaxed))));
+                menu->addChild(createMenuLabel(string::f("Substep cap hits: %u, blow-ups: %u",
+                    stats.capHits.load(relaxed), stats.blowups.load(relaxed))));
+                menu->addChild(createMenuLabel(string::f("Bounds: %.2f x %.2f x %.2f",
+                    stats.spanX.load(relaxed), stats.spanY.load(relaxed), stats.spanZ.load(relaxed))));
+                menu->addChild(createMenuLabel(string::f("Integration: ~%.0f ns/sample (%.2f%% CPU)",
+                    stats.nsPerSample.load(relaxed), stats.nsPerSample.load(relaxed) * APP->engine->getSampleRate() * 1e-7f)));
+            }
+            menu->addChild(new MenuSeparator());
+            menu->addChild(createBoolPtrMenuItem("Show on display", "", &module->statsOverlay));
+        }));
+
+        menu->addChild(createSubmenuItem("Record", module->recorder.isRecording() ? "Recording" : "", [=](Menu* menu) {
+            TrajectoryRecorder& recorder = module->recorder;
+            bool recording = recorder.isRecording();
+            menu->addChild(createMenuItem(recording ? "Stop recording" : "Start recording", "",
+                [=]() { module->toggleRecording(); }
+            ));
+            menu->addChild(createIndexPtrSubmenuItem("Format", {"WAV (32-bit float)", "CSV"}, &module->recordFormat));
+            float sampleRate = APP->engine->getSampleRate();
+            std::vector<std::string> decimationLabels;
+            for (int k = 0; k < StrangeWeather::NUM_RECORD_DECIMATIONS; k++) {
+                int factor = StrangeWeather::recordDecimationFactor(k);
+                std::string label = (factor == 1) ? string::f("Every sample (%g Hz", sampleRate)
+                                                  : string::f("Average of %d (%g Hz", factor, sampleRate / factor);
+                // WAV headers only hold whole hertz
+                float frameRate = sampleRate / factor;
+                if ((float)TrajectoryRecorder::wavRate(frameRate) != frameRate) {
+                    label += string::f(", %u Hz in WAV", TrajectoryRecorder::wavRate(frameRate));
+                }
+                decimationLabels.push_back(label + ")");
+            }
+            menu->addChild(createIndexPtrSubmenuItem("Decimation", decimationLabels, &module->recordDecimation));
+            std::string path = recorder.currentPath();
+            bool failed = recorder.failed.load(std::memory_order_relaxed);
+            if (recording || failed || recorder.written.load(std::memory_order_relaxed) > 0) {
+                menu->addChild(new MenuSeparator());
+                menu->addChild(createMenuLabel(system::getFilename(path)));
+                float rate = recorder.rate.load(std::memory_order_relaxed);
+                uint32_t headerRate = TrajectoryRecorder::wavRate(rate);
+                bool rounded = recorder.format == TrajectoryRecorder::WAV && (float)headerRate != rate;
+                menu->addChild(createMenuLabel(rounded ? string::f("%g Hz frames, %u Hz in the WAV header", rate, headerRate)
+                                                       : string::f("%g Hz frames", rate)));
+                menu->addChild(createMenuLabel(string::f("%llu frames written, %u dropped",
+                    (unsigned long long)recorder.written.load(std::memory_order_relaxed),
+                    recorder.dropped.load(std::memory_order_relaxed))));
+                if (failed) {
+                    menu->addChild(createMenuLabel("Could not write the file"));
+                }
+            }
+        }));
+
         menu->addChild(new MenuSeparator());
         menu->addChild(createBoolPtrMenuItem("Ajman", "", &module->ajmanEnabled));
     }
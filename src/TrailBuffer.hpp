@@ -0,0 +1,256 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+
+// Trail samples are clamped to [-1, 1] and only ever drawn, so by default they are stored
+// as 16-bit fixed point, halving the trail memory. Build with
+// -DSTRANGEWEATHER_FLOAT_TRAILS to keep full floats.
+#ifdef STRANGEWEATHER_FLOAT_TRAILS
+typedef float TrailValue;
+inline TrailValue encodeTrailValue(float v) { return v; }
+inline float decodeTrailValue(TrailValue v) { return v; }
+#else
+typedef int16_t TrailValue;
+inline TrailValue encodeTrailValue(float v) {
+    v = std::min(std::max(v, -1.f), 1.f) * 32767.f;
+    return (TrailValue)(v + (v >= 0.f ? 0.5f : -0.5f));
+}
+inline float decodeTrailValue(TrailValue v) { return v * (1.f / 32767.f); }
+#endif
+
+// One trail sample: x, y and z stored together so a point is read from one place
+struct TrailPoint {
+    TrailValue v[3];
+
+    void set(float x, float y, float z) {
+        v[0] = encodeTrailValue(x);
+        v[1] = encodeTrailValue(y);
+        v[2] = encodeTrailValue(z);
+    }
+    float get(int axis) const { return decodeTrailValue(v[axis]); }
+    float x() const { return get(0); }
+    float y() const { return get(1); }
+    float z() const { return get(2); }
+};
+
+
+// Display trail history written by the engine thread (one sample per display tick) for
+// the four banks and the combined view. `valid` counts the samples appended since the
+// trail was last cleared; readers treat every older slot as a repeat of the oldest valid
+// sample, so clearing is O(1) and never touches the history. Every modification is
+// bracketed by beginWrite()/endWrite(), which bump a sequence counter (odd while a write
+// is in progress), so the UI can take consistent copies without the engine ever waiting.
+struct TrailBuffer {
+    static const int SOURCES = 5;   // Banks A-D, then the combined trail
+    static const int COMBINED = 4;
+    static const int LENGTH = 4096;
+
+    TrailPoint points[SOURCES][LENGTH] = {};
+    int index = 0;         // Slot of the newest sample
+    int valid = 0;         // Samples appended since the last clear (at most LENGTH)
+    uint32_t written = 0;  // Samples appended so far
+    std::atomic<uint32_t> sequence{0};
+
+    void beginWrite() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void endWrite() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Start a new trail: the next sample appended fills the whole history
+    void clear() {
+        beginWrite();
+        valid = 0;
+        endWrite();
+    }
+
+    // Advance to the next slot and count it; the caller writes the sample there between
+    // beginWrite() and endWrite()
+    int advance() {
+        index = (index + 1) % LENGTH;
+        valid = std::min(valid + 1, LENGTH);
+        written++;
+        return index;
+    }
+};
+
+
+// Min/max pyramid over a trail copy, so long trails can be drawn at the display's
+// resolution without losing peaks. Level k holds the extremes per axis of every aligned
+// block of 2^k slots, for k = MIN_LEVEL..LEVELS. Shorter runs at the ends of a range are
+// scanned from the trail itself.
+struct TrailLod {
+    static const int LEVELS = 12;
+    static const int MIN_LEVEL = 2;
+    static_assert(TrailBuffer::LENGTH == 1 << LEVELS, "the pyramid spans the whole ring");
+
+    struct Extremes {
+        TrailValue lo[3], hi[3];
+    };
+    // Every level, packed from MIN_LEVEL up
+    Extremes blocks[TrailBuffer::SOURCES][TrailBuffer::LENGTH >> (MIN_LEVEL - 1)];
+
+    static int offset(int level) {
+        // Blocks below `level`: LENGTH / 2^MIN_LEVEL + ... + LENGTH / 2^(level - 1)
+        return (TrailBuffer::LENGTH >> (MIN_LEVEL - 1)) - (TrailBuffer::LENGTH >> (level - 1));
+    }
+
+    // Recompute the blocks containing `slot` on every level
+    void update(const TrailPoint (*points)[TrailBuffer::LENGTH], int slot) {
+        for (int s = 0; s < TrailBuffer::SOURCES; s++) {
+            // Lowest level straight from the trail, the others from their two children
+            int block = slot >> MIN_LEVEL;
+            Extremes& e = blocks[s][offset(MIN_LEVEL) + block];
+            const TrailPoint* p = points[s] + (block << MIN_LEVEL);
+            for (int axis = 0; axis < 3; axis++) {
+                TrailValue lo = p[0].v[axis], hi = lo;
+                for (int k = 1; k < 1 << MIN_LEVEL; k++) {
+                    lo = std::min(lo, p[k].v[axis]);
+                    hi = std::max(hi, p[k].v[axis]);
+                }
+                e.lo[axis] = lo;
+                e.hi[axis] = hi;
+            }
+            for (int level = MIN_LEVEL + 1; level <= LEVELS; level++) {
+                block >>= 1;
+                const Extremes& a = blocks[s][offset(level - 1) + 2 * block];
+                const Extremes& b = blocks[s][offset(level - 1) + 2 * block + 1];
+                Extremes& parent = blocks[s][offset(level) + block];
+                for (int axis = 0; axis < 3; axis++) {
+                    parent.lo[axis] = std::min(a.lo[axis], b.lo[axis]);
+                    parent.hi[axis] = std::max(a.hi[axis], b.hi[axis]);
+                }
+            }
+        }
+    }
+
+    void rebuild(const TrailPoint (*points)[TrailBuffer::LENGTH]) {
+        for (int slot = 0; slot < TrailBuffer::LENGTH; slot += 1 << MIN_LEVEL) {
+            update(points, slot);
+        }
+    }
+
+    // Extremes on `axis` of slots [begin, end) of `source`, merged into lo/hi
+    void range(const TrailPoint* points, int source, int axis, int begin, int end,
+               TrailValue& lo, TrailValue& hi) const {
+        while (begin < end) {
+            // Largest aligned block starting at begin that fits, else a single slot
+            int level = MIN_LEVEL - 1;
+            while (level < LEVELS && (begin & ((2 << level) - 1)) == 0 && begin + (2 << level) <= end) {
+                level++;
+            }
+            if (level < MIN_LEVEL) {
+                lo = std::min(lo, points[begin].v[axis]);
+                hi = std::max(hi, points[begin].v[axis]);
+                begin++;
+            }
+            else {
+                const Extremes& e = blocks[source][offset(level) + (begin >> level)];
+                lo = std::min(lo, e.lo[axis]);
+                hi = std::max(hi, e.hi[axis]);
+                begin += 1 << level;
+            }
+        }
+    }
+};
+
+
+// UI-thread copy of a TrailBuffer. update() copies only the samples appended since the
+// previous update and retries if the engine wrote meanwhile; a copy that can't be
+// completed is left for the next frame. The min/max pyramid is kept up to date with it.
+struct TrailSnapshot {
+    TrailPoint points[TrailBuffer::SOURCES][TrailBuffer::LENGTH] = {};
+    TrailLod lod;
+    int index = 0;
+    int valid = 0;
+    uint32_t written = 0;
+    bool copied = false;  // Holds a complete copy
+
+    // Slot of the sample `age` ticks before the newest; ages past the valid history
+    // resolve to the oldest valid sample
+    int slot(int age) const {
+        age = std::min(age, std::max(valid - 1, 0));
+        return (index - age + TrailBuffer::LENGTH) % TrailBuffer::LENGTH;
+    }
+
+    // Lowest and highest value on `axis` of `source` over ages newest..oldest (inclusive),
+    // with the same clamping to the valid history as slot()
+    void extremes(int source, int axis, int newest, int oldest, float& lo, float& hi) const {
+        int first = slot(oldest);
+        int last = slot(newest);
+        TrailValue l = points[source][first].v[axis], h = l;
+        if (first <= last) {
+            lod.range(points[source], source, axis, first, last + 1, l, h);
+        }
+        else {
+            lod.range(points[source], source, axis, first, TrailBuffer::LENGTH, l, h);
+            lod.range(points[source], source, axis, 0, last + 1, l, h);
+        }
+        lo = decodeTrailValue(l);
+        hi = decodeTrailValue(h);
+    }
+
+    // Returns true if the snapshot changed
+    bool update(const TrailBuffer& src) {
+        const int maxAttempts = 4;
+        for (int attempt = 0; attempt < maxAttempts; attempt++) {
+            uint32_t seq = src.sequence.load(std::memory_order_acquire);
+            if (seq & 1)
+                continue;
+
+            uint32_t srcWritten = src.written;
+            int srcIndex = src.index;
+            int srcValid = src.valid;
+            if (copied && srcWritten == written && srcValid == valid)
+                return false;
+
+            bool full = !copied || srcWritten - written > (uint32_t)TrailBuffer::LENGTH;
+            if (full) {
+                std::memcpy(points, src.points, sizeof(points));
+            }
+            else {
+                // Walk back from the newest slot over the samples we haven't seen
+                int count = (int)(srcWritten - written);
+                for (int n = 0; n < count; n++) {
+                    int j = (srcIndex - n + TrailBuffer::LENGTH) % TrailBuffer::LENGTH;
+                    for (int s = 0; s < TrailBuffer::SOURCES; s++) {
+                        points[s][j] = src.points[s][j];
+                    }
+                }
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (src.sequence.load(std::memory_order_relaxed) != seq)
+                continue;  // Torn copy; the counters are unchanged, so just redo it
+
+            if (full) {
+                lod.rebuild(points);
+            }
+            else {
+                // Each lowest-level block once, newest first
+                int count = (int)(srcWritten - written);
+                int lastBlock = -1;
+                for (int n = 0; n < count; n++) {
+                    int j = (srcIndex - n + TrailBuffer::LENGTH) % TrailBuffer::LENGTH;
+                    if (j >> TrailLod::MIN_LEVEL != lastBlock) {
+                        lastBlock = j >> TrailLod::MIN_LEVEL;
+                        lod.update(points, j);
+                    }
+                }
+            }
+
+            index = srcIndex;
+            valid = srcValid;
+            written = srcWritten;
+            copied = true;
+            return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,276 @@
+#include "TrajectoryRecorder.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+
+namespace {
+
+// How often the writer drains the ring. Frames are written BATCH_FRAMES at a time, or
+// whatever has arrived after FLUSH_INTERVAL seconds at low frame rates.
+const std::chrono::milliseconds POLL_INTERVAL(10);
+const size_t BATCH_FRAMES = 8192;  // 640 KB of WAV
+const double FLUSH_INTERVAL = 1.0;
+
+const char* CHANNEL_NAMES[TrajectoryRecorder::CHANNELS] = {
+    "A X", "A Y", "A Z", "A SUM",
+    "B X", "B Y", "B Z", "B SUM",
+    "C X", "C Y", "C Z", "C SUM",
+    "D X", "D Y", "D Z", "D SUM",
+    "COMB SUM", "COMB RECT", "COMB INV", "COMB DIST",
+};
+
+// WAVE_FORMAT_EXTENSIBLE with 32-bit float samples: RIFF, fmt (40 bytes), fact and data
+const uint32_t WAV_HEADER_SIZE = 12 + 48 + 12 + 8;
+const uint32_t FRAME_BYTES = sizeof(TrajectoryRecorder::Frame);
+// Most frames whose sizes still fit the 32-bit RIFF fields
+const uint64_t WAV_MAX_FRAMES = (0xffffffffULL - WAV_HEADER_SIZE) / FRAME_BYTES;
+
+void put16(uint8_t*& p, uint16_t v) {
+    *p++ = v & 0xff;
+    *p++ = v >> 8;
+}
+
+void put32(uint8_t*& p, uint32_t v) {
+    put16(p, v & 0xffff);
+    put16(p, v >> 16);
+}
+
+void putTag(uint8_t*& p, const char* tag) {
+    std::memcpy(p, tag, 4);
+    p += 4;
+}
+
+// Header for `frames` frames, written at the start of the file
+bool writeWavHeader(std::FILE* f, uint32_t rate, uint64_t frames) {
+    const uint8_t floatGuid[16] = {0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+                                   0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71};
+    uint32_t dataBytes = (uint32_t)(frames * FRAME_BYTES);
+    uint8_t header[WAV_HEADER_SIZE];
+    uint8_t* p = header;
+    putTag(p, "RIFF");
+    put32(p, WAV_HEADER_SIZE - 8 + dataBytes);
+    putTag(p, "WAVE");
+    putTag(p, "fmt ");
+    put32(p, 40);
+    put16(p, 0xfffe);  // WAVE_FORMAT_EXTENSIBLE
+    put16(p, TrajectoryRecorder::CHANNELS);
+    put32(p, rate);
+    put32(p, rate * FRAME_BYTES);
+    put16(p, FRAME_BYTES);
+    put16(p, 32);
+    put16(p, 22);
+    put16(p, 32);  // Valid bits
+    put32(p, 0);   // No speaker positions
+    std::memcpy(p, floatGuid, 16);
+    p += 16;
+    putTag(p, "fact");
+    put32(p, 4);
+    put32(p, (uint32_t)frames);
+    putTag(p, "data");
+    put32(p, dataBytes);
+    return std::fseek(f, 0, SEEK_SET) == 0 &&
+           std::fwrite(header, WAV_HEADER_SIZE, 1, f) == 1 &&
+           std::fseek(f, 0, SEEK_END) == 0;
+}
+
+}  // namespace
+
+
+bool TrajectoryRecorder::start(Format format, int decimation, float sampleRate) {
+    stop();
+    if (ring.empty()) {
+        ring.resize(RING_FRAMES);
+    }
+    this->format = format;
+    frameRate = sampleRate / decimation;
+    partStart = 0.0;
+
+    // Named after the local time; another instance may have started in the same second
+    std::string dir = asset::user("StrangeWeather/recordings");
+    system::createDirectories(dir);
+    char stamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+    std::string name = system::join(dir, std::string("strange-weather-") + stamp);
+    basePath = name;
+    part.store(1, std::memory_order_relaxed);
+    for (int n = 2; system::exists(currentPath()); n++) {
+        basePath = name + "_" + std::to_string(n);
+    }
+    written.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+    failed.store(false, std::memory_order_relaxed);
+    this->decimation.store(decimation, std::memory_order_relaxed);
+    return launch();
+}
+
+
+void TrajectoryRecorder::setSampleRate(float sampleRate) {
+    if (!writer.joinable() || failed.load(std::memory_order_relaxed))
+        return;
+    float newRate = sampleRate / decimation.load(std::memory_order_relaxed);
+    if (newRate == frameRate)
+        return;
+    // Everything in the ring so far was averaged at the old rate
+    stop();
+    partStart += fileFrames / frameRate;
+    frameRate = newRate;
+    part.fetch_add(1, std::memory_order_relaxed);
+    launch();
+}
+
+
+// Open the current part at frameRate and start the writer on it
+bool TrajectoryRecorder::launch() {
+    rate.store(frameRate, std::memory_order_relaxed);
+    if (!openFile()) {
+        failed.store(true, std::memory_order_relaxed);
+        return false;
+    }
+    if (format == WAV && (float)wavRate(frameRate) != frameRate) {
+        WARN("Strange Weather recording %s at %g Hz has a WAV header rate of %u Hz", currentPath().c_str(),
+             frameRate, wavRate(frameRate));
+    }
+    // Skip anything left in the ring by the previous recording
+    readIndex.store(writeIndex.load(std::memory_order_acquire), std::memory_order_relaxed);
+    session.fetch_add(1, std::memory_order_relaxed);
+    stopping.store(false, std::memory_order_relaxed);
+    writer = std::thread([this]() { run(); });
+    active.store(true, std::memory_order_release);
+    return true;
+}
+
+
+void TrajectoryRecorder::stop() {
+    if (!writer.joinable())
+        return;
+    active.store(false, std::memory_order_relaxed);
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+    closeFile();
+}
+
+
+std::string TrajectoryRecorder::currentPath() const {
+    int n = part.load(std::memory_order_relaxed);
+    std::string path = (n > 1) ? basePath + "-" + std::to_string(n) : basePath;
+    return path + ((format == WAV) ? ".wav" : ".csv");
+}
+
+
+void TrajectoryRecorder::run() {
+    system::setThreadName("Strange Weather recorder");
+    std::vector<Frame> batch;
+    batch.reserve(BATCH_FRAMES);
+    double lastWrite = system::getTime();
+    while (true) {
+        bool last = stopping.load(std::memory_order_acquire);
+        uint32_t r = readIndex.load(std::memory_order_relaxed);
+        uint32_t w = writeIndex.load(std::memory_order_acquire);
+        while (r != w && batch.size() < BATCH_FRAMES) {
+            batch.push_back(ring[r & (RING_FRAMES - 1)]);
+            r++;
+        }
+        readIndex.store(r, std::memory_order_release);
+
+        bool full = batch.size() >= BATCH_FRAMES;
+        double now = system::getTime();
+        if (full || last || now - lastWrite >= FLUSH_INTERVAL) {
+            if (!batch.empty()) {
+                writeFrames(batch.data(), (int)batch.size());
+            }
+            batch.clear();
+            lastWrite = now;
+        }
+        if (last && r == w)
+            break;
+        if (!full && !last) {
+            std::this_thread::sleep_for(POLL_INTERVAL);
+        }
+    }
+}
+
+
+bool TrajectoryRecorder::openFile() {
+    file = std::fopen(currentPath().c_str(), "wb");
+    if (!file)
+        return false;
+    fileFrames = 0;
+    bool ok;
+    if (format == WAV) {
+        ok = writeWavHeader(file, wavRate(frameRate), 0);
+    }
+    else {
+        std::string header = "time";
+        for (const char* name : CHANNEL_NAMES) {
+            header += std::string(",") + name;
+        }
+        header += "\n";
+        ok = std::fwrite(header.data(), 1, header.size(), file) == header.size();
+    }
+    if (!ok) {
+        std::fclose(file);
+        file = nullptr;
+    }
+    return ok;
+}
+
+
+void TrajectoryRecorder::closeFile() {
+    if (!file)
+        return;
+    if (format == WAV) {
+        writeWavHeader(file, wavRate(frameRate), fileFrames);
+    }
+    std::fclose(file);
+    file = nullptr;
+}
+
+
+void TrajectoryRecorder::writeFrames(const Frame* frames, int count) {
+    if (failed.load(std::memory_order_relaxed))
+        return;
+    bool ok = true;
+    if (format == WAV) {
+        while (count > 0 && ok) {
+            if (fileFrames == WAV_MAX_FRAMES) {
+                closeFile();
+                part.fetch_add(1, std::memory_order_relaxed);
+                if (!openFile()) {
+                    ok = false;
+                    break;
+                }
+            }
+            int n = (int)std::min((uint64_t)count, WAV_MAX_FRAMES - fileFrames);
+            ok = std::fwrite(frames, FRAME_BYTES, n, file) == (size_t)n;
+            fileFrames += n;
+            written.fetch_add(n, std::memory_order_relaxed);
+            frames += n;
+            count -= n;
+        }
+        // Keep the sizes current, so a crash still leaves a readable file
+        ok = ok && writeWavHeader(file, wavRate(frameRate), fileFrames);
+    }
+    else {
+        std::string text;
+        text.reserve((size_t)count * CHANNELS * 12);
+        char field[32];
+        for (int i = 0; i < count; i++) {
+            std::snprintf(field, sizeof(field), "%.6f", partStart + (double)(fileFrames + i) / frameRate);
+            text += field;
+            for (int k = 0; k < CHANNELS; k++) {
+                std::snprintf(field, sizeof(field), ",%.6g", frames[i].values[k]);
+                text += field;
+            }
+            text += '\n';
+        }
+        ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+        fileFrames += count;
+        written.fetch_add(count, std::memory_order_relaxed);
+    }
+    if (!ok) {
+        failed.store(true, std::memory_order_relaxed);
+    }
+}
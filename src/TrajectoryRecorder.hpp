@@ -0,0 +1,131 @@
+#pragma once
+#include "plugin.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Records the module's outputs to a file for as long as needed (hours at Low range). The
+// audio thread averages every `decimation` samples into a frame and pushes it into a
+// single-producer single-consumer ring. A writer thread drains the ring and writes it in
+// large batches to a multichannel WAV (32-bit float) or CSV file. Only start() and stop()
+// allocate or touch the filesystem, and they run on the UI thread.
+struct TrajectoryRecorder {
+    // Channel 1 of X, Y, Z and SUM for banks A-D, then the four combined outputs: the same
+    // order as the module's outputs
+    static const int CHANNELS = 20;
+    static const int RING_FRAMES = 1 << 16;  // Power of two
+
+    enum Format {
+        WAV,
+        CSV
+    };
+
+    struct Frame {
+        float values[CHANNELS];
+    };
+
+    ~TrajectoryRecorder() {
+        stop();
+    }
+
+    // UI thread: open a new file in the Rack user folder and start recording into it.
+    // Returns false and sets `failed`, recording nothing, if the file can't be created.
+    bool start(Format format, int decimation, float sampleRate);
+    // UI thread: stop recording, write out what is left and close the file
+    void stop();
+    // Engine sample rate change, while process() isn't running: a recording in progress
+    // closes its file and carries on in the next numbered part at the new frame rate
+    void setSampleRate(float sampleRate);
+
+    bool isRecording() const {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    // Audio thread: add one sample of all CHANNELS values. Frames that don't fit in the
+    // ring (the writer stalled for too long) are dropped and counted.
+    void process(const float* values) {
+        if (!active.load(std::memory_order_acquire))
+            return;
+        uint32_t current = session.load(std::memory_order_relaxed);
+        if (current != seenSession) {
+            seenSession = current;
+            accumulated = 0;
+            std::fill(sum, sum + CHANNELS, 0.f);
+        }
+        for (int k = 0; k < CHANNELS; k++) {
+            sum[k] += values[k];
+        }
+        int factor = decimation.load(std::memory_order_relaxed);
+        if (++accumulated < factor)
+            return;
+
+        uint32_t w = writeIndex.load(std::memory_order_relaxed);
+        if (w - readIndex.load(std::memory_order_acquire) >= (uint32_t)RING_FRAMES) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        else {
+            Frame& frame = ring[w & (RING_FRAMES - 1)];
+            float scale = 1.f / factor;
+            for (int k = 0; k < CHANNELS; k++) {
+                frame.values[k] = sum[k] * scale;
+            }
+            writeIndex.store(w + 1, std::memory_order_release);
+        }
+        accumulated = 0;
+        std::fill(sum, sum + CHANNELS, 0.f);
+    }
+
+    // UI thread: the file being written, or the last one written. WAV recordings move on
+    // to a numbered next part when they reach the 4 GB limit of the format.
+    std::string currentPath() const;
+
+    // For the UI, kept after stop()
+    std::atomic<uint64_t> written{0};  // Frames written to disk
+    std::atomic<uint32_t> dropped{0};  // Frames lost to a full ring
+    std::atomic<bool> failed{false};   // A write failed; the rest of the recording is discarded
+    std::atomic<float> rate{0.f};      // Frame rate of the current part, in Hz
+    // Sample rate WAV headers give for `frameRate`: whole hertz only, so 44.1 kHz
+    // averaged over 1000 samples plays back at 44 Hz (CSV time columns stay exact)
+    static uint32_t wavRate(float frameRate) {
+        return (uint32_t)std::max(std::round(frameRate), 1.f);
+    }
+
+    // Allocated by the first start() and kept, so the audio thread never sees it move
+    std::vector<Frame> ring;
+    std::atomic<uint32_t> writeIndex{0};  // Next frame the audio thread fills
+    std::atomic<uint32_t> readIndex{0};   // Next frame the writer takes
+    std::atomic<bool> active{false};
+    std::atomic<bool> stopping{false};
+    // Bumped by each start(), so the audio thread drops a partial block left over from
+    // the previous recording
+    std::atomic<uint32_t> session{0};
+    std::atomic<int> decimation{1};
+    std::thread writer;
+
+    // Audio thread only
+    uint32_t seenSession = 0;
+    int accumulated = 0;
+    float sum[CHANNELS] = {};
+
+    // Writer thread, set up by start()
+    Format format = WAV;
+    float frameRate = 48000.f;
+    double partStart = 0.0;  // Time of the first frame of the current part, for CSV
+    std::string basePath;  // Without the part number and extension
+    std::atomic<int> part{1};
+    std::FILE* file = nullptr;
+    uint64_t fileFrames = 0;
+
+    void run();
+    bool launch();
+    bool openFile();
+    void closeFile();
+    void writeFrames(const Frame* frames, int count);
+};